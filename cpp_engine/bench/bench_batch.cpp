@@ -0,0 +1,100 @@
+// File: /cpp_engine/bench/bench_batch.cpp
+// Microbenchmark: per-tick streaming indicators vs. BatchIndicators (scalar, AVX2) over one series.
+
+#include "../include/BatchIndicators.h"
+#include "../include/Indicators.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+struct Series {
+    vector<double> vwap, sma_20, ema_20, ema_50, bb_mid, bb_variance;
+
+    explicit Series(size_t n) : vwap(n), sma_20(n), ema_20(n), ema_50(n), bb_mid(n), bb_variance(n) {}
+};
+
+static double max_diff(const vector<double>& a, const vector<double>& b) {
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::isnan(a[i]) != std::isnan(b[i])) return INFINITY;
+        if (!std::isnan(a[i])) worst = max(worst, fabs(a[i] - b[i]));
+    }
+    return worst;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? stoul(argv[1]) : 2000000;
+    int rounds = argc > 2 ? stoi(argv[2]) : 5;
+
+    // A random walk around 43000 spanning a few UTC days
+    TickColumns ticks;
+    double price = 43000.0;
+    unsigned state = 12345;
+    for (size_t i = 0; i < n; ++i) {
+        state = state * 1103515245u + 12345u;
+        price += (static_cast<int>((state >> 16) % 201) - 100) * 0.01;
+        ticks.timestamp_ms.push_back(1700000000000LL + (long long)i * 150);
+        ticks.trade_id.push_back((long long)i);
+        ticks.close.push_back(price);
+        ticks.volume.push_back(0.001 + ((state >> 8) % 97) * 0.0013);
+    }
+
+    Series streaming(n);
+    double secs = 0.0;
+    for (int r = 0; r < rounds; ++r) {
+        SessionVwap vwap;
+        Sma sma(20);
+        EmaBank<20, 50> emas;
+        Bollinger bands(20, 1.0);
+        auto start = chrono::steady_clock::now();
+        TickerData tick;
+        memset(&tick, 0, sizeof(tick));
+        for (size_t i = 0; i < n; ++i) {
+            tick.timestamp_ms = ticks.timestamp_ms[i];
+            tick.open = tick.high = tick.low = tick.close = ticks.close[i];
+            tick.volume = ticks.volume[i];
+            vwap.update(tick);
+            sma.update(tick);
+            emas.add(tick.close);
+            bands.update(tick);
+            streaming.vwap[i] = vwap.value(0);
+            streaming.sma_20[i] = sma.value(0);
+            streaming.ema_20[i] = emas.current(0);
+            streaming.ema_50[i] = emas.current(1);
+            streaming.bb_mid[i] = bands.value(0);
+            double width = bands.value(1) - bands.value(0); // k = 1: one standard deviation
+            streaming.bb_variance[i] = width * width;
+        }
+        secs += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    cout << "streaming (per tick): " << (secs * 1e9 / (n * rounds)) << " ns/tick" << endl;
+
+    for (auto kernel : {BatchIndicators::Kernel::Scalar, BatchIndicators::Kernel::AVX2}) {
+        BatchIndicators batch;
+        batch.set_kernel(kernel);
+        if (batch.kernel() != kernel) continue;
+
+        Series out(n);
+        secs = 0.0;
+        for (int r = 0; r < rounds; ++r) {
+            auto start = chrono::steady_clock::now();
+            batch.session_vwap(ticks.timestamp_ms.data(), ticks.close.data(), ticks.volume.data(), n, out.vwap.data());
+            batch.sma(ticks.close.data(), n, 20, out.sma_20.data());
+            batch.ema(ticks.close.data(), n, 20, out.ema_20.data());
+            batch.ema(ticks.close.data(), n, 50, out.ema_50.data());
+            batch.rolling_variance(ticks.close.data(), n, 20, out.bb_mid.data(), out.bb_variance.data());
+            secs += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        }
+        cout << "batch[" << BatchIndicators::kernel_name(kernel) << "]: " << (secs * 1e9 / (n * rounds))
+             << " ns/tick; max |diff| vs streaming: vwap " << max_diff(out.vwap, streaming.vwap)
+             << ", sma " << max_diff(out.sma_20, streaming.sma_20)
+             << ", ema20 " << max_diff(out.ema_20, streaming.ema_20)
+             << ", ema50 " << max_diff(out.ema_50, streaming.ema_50)
+             << ", variance " << max_diff(out.bb_variance, streaming.bb_variance) << endl;
+    }
+    return 0;
+}
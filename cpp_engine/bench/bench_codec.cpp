@@ -0,0 +1,167 @@
+// File: /cpp_engine/bench/bench_codec.cpp
+// Bytes and scan speed of one symbol's trades kept as raw_ohlcv_data rows, as plain columnar
+// segments, and as compressed segments (fixed-point and XOR prices/quantities).
+// Usage: bench_codec [trades] [schema.sql]
+
+#include "../include/Constants.h"
+#include "../include/Persistence.h"
+#include "../include/ColumnarTickStore.h"
+#include "../include/sqlite3.h"
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char* BENCH_DB = "bench_codec.db";
+static const char* BENCH_TICK_DIR = "bench_codec_ticks";
+static const char* BENCH_XOR_DIR = "bench_codec_ticks_xor";
+
+// A random walk on a 0.01 tick with bursty arrivals and 5-decimal quantities, spread over
+// three days so that every segment but the last is sealed by a day change
+static vector<TickerData> make_trades(size_t count) {
+    vector<TickerData> trades(count);
+    SymbolId symbol_id = intern_symbol("BTCUSDT");
+    mt19937_64 rng(42);
+    geometric_distribution<int> gap(0.05);
+    uniform_int_distribution<int> step(-3, 3);
+    lognormal_distribution<double> size(-5.0, 1.5);
+    long long day_ms = 24LL * 60 * 60 * 1000;
+    long long spacing = max(1LL, 3 * day_ms / (long long)max<size_t>(count, 1) / 20);
+    long long timestamp = 1700006400000LL; // 2023-11-15 00:00 UTC
+    long long cents = 4300000;
+    for (size_t i = 0; i < count; ++i) {
+        TickerData& t = trades[i];
+        timestamp += gap(rng) * spacing;
+        cents += step(rng);
+        t.timestamp_ms = timestamp;
+        t.symbol_id = symbol_id;
+        t.flags = 0;
+        t.trade_id = 3000000000LL + (long long)i;
+        t.open = t.high = t.low = t.close = cents / 100.0;
+        t.volume = max(1e-5, round(size(rng) * 1e5) / 1e5);
+    }
+    return trades;
+}
+
+static bool create_db(const string& schema_path) {
+    remove(BENCH_DB);
+    ifstream in(schema_path);
+    if (!in) {
+        cerr << "Cannot read schema: " << schema_path << endl;
+        return false;
+    }
+    stringstream schema;
+    schema << in.rdbuf();
+
+    sqlite3* db;
+    sqlite3_open(BENCH_DB, &db);
+    bool ok = sqlite3_exec(db, schema.str().c_str(), 0, 0, 0) == SQLITE_OK;
+    sqlite3_close(db);
+    return ok;
+}
+
+static void write_batches(PersistenceBackend& backend, const vector<TickerData>& trades) {
+    vector<TickerData> batch;
+    for (size_t i = 0; i < trades.size(); i += BATCH_SIZE) {
+        batch.assign(trades.begin() + i, trades.begin() + min(trades.size(), i + BATCH_SIZE));
+        backend.begin_transaction();
+        backend.insert_raw_batch(batch);
+        backend.commit_transaction();
+    }
+}
+
+static uint64_t directory_bytes(const string& directory) {
+    uint64_t bytes = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(directory)) {
+        if (entry.is_regular_file()) bytes += entry.file_size();
+    }
+    return bytes;
+}
+
+// Full scan of all four columns, summed so the decode cannot be optimized away
+static void report_scan(const char* name, const ColumnarTickStore& store, size_t count, uint64_t bytes) {
+    double checksum = 0;
+    size_t rows = 0;
+    auto start = chrono::steady_clock::now();
+    store.scan("BTCUSDT", 0, LLONG_MAX, TICK_COLUMN_ALL, [&](const TickBlockView& block) {
+        for (size_t i = 0; i < block.rows; ++i) {
+            checksum += block.price[i] * block.qty[i] + double(block.timestamp_ms[i] - block.trade_id[i]);
+        }
+        rows += block.rows;
+    });
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << name << ": " << bytes << " bytes (" << double(bytes) / count << " B/trade), scanned " << rows
+         << " trades in " << secs * 1000 << " ms, " << static_cast<long long>(rows / secs) << " trades/sec"
+         << " [checksum " << checksum << "]" << endl;
+}
+
+static void report_compression(const char* name, const TickCompressionStats& stats, double secs) {
+    const char* columns[4] = {"timestamp", "trade_id", "price", "qty"};
+    uint64_t packed = 0;
+    for (uint64_t bytes : stats.column_bytes) packed += bytes;
+    cout << name << ": " << stats.raw_bytes << " -> " << packed << " column bytes ("
+         << double(stats.raw_bytes) / packed << "x) in " << secs * 1000 << " ms; bits/value";
+    for (size_t c = 0; c < 4; ++c) cout << " " << columns[c] << " " << 8.0 * stats.column_bytes[c] / stats.rows;
+    cout << "; fixed-point price/qty blocks " << stats.fixed_point_blocks << "/" << 2 * stats.blocks << endl;
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? stoul(argv[1]) : 1000000;
+    string schema_path = argc > 2 ? argv[2] : "../../db_setup/schema.sql";
+    vector<TickerData> trades = make_trades(count);
+
+    if (!create_db(schema_path)) return 1;
+    fs::remove_all(BENCH_TICK_DIR);
+    fs::remove_all(BENCH_XOR_DIR);
+    {
+        PersistenceManager manager;
+        manager.open_db(BENCH_DB);
+        streambuf* saved = cout.rdbuf(nullptr); // Silence per-commit logging
+        write_batches(manager, trades);
+        ColumnarTickStore store(manager, BENCH_TICK_DIR);
+        store.open();
+        write_batches(store, trades);
+        store.close();
+        cout.rdbuf(saved);
+
+        TickColumns ticks;
+        auto start = chrono::steady_clock::now();
+        manager.load_ticks("BTCUSDT", ticks);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        manager.close_db();
+        cout << "raw_ohlcv_data: " << fs::file_size(BENCH_DB) << " bytes (with indexes), loaded " << ticks.size()
+             << " trades in " << secs * 1000 << " ms, " << static_cast<long long>(ticks.size() / secs)
+             << " trades/sec" << endl;
+
+        report_scan("plain segments", store, count, directory_bytes(BENCH_TICK_DIR));
+    }
+    fs::copy(BENCH_TICK_DIR, BENCH_XOR_DIR, fs::copy_options::recursive);
+
+    // The last day's segment is sealed too (close()), so compress everything
+    const char* variants[2][2] = {{"fixed point", BENCH_TICK_DIR}, {"XOR", BENCH_XOR_DIR}};
+    for (int v = 0; v < 2; ++v) {
+        TickCompressionStats stats;
+        auto start = chrono::steady_clock::now();
+        if (!compress_tick_segments(variants[v][1], LLONG_MAX, v == 0, stats)) return 1;
+        report_compression(variants[v][0], stats, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+
+        PersistenceManager unused;
+        ColumnarTickStore store(unused, variants[v][1]);
+        report_scan(variants[v][0], store, count, directory_bytes(variants[v][1]));
+    }
+
+    fs::remove_all(BENCH_TICK_DIR);
+    fs::remove_all(BENCH_XOR_DIR);
+    remove(BENCH_DB);
+    return 0;
+}
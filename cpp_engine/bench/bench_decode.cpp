@@ -0,0 +1,80 @@
+// File: /cpp_engine/bench/bench_decode.cpp
+// Microbenchmark: per-line from_chars parsing vs. TickDecoder batch decoding of a receive buffer.
+
+#include "../include/TickDecoder.h"
+#include "../include/TickerData.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// One ~32 KB receive buffer of binance_data_fetcher.py-shaped lines
+static string make_buffer(size_t lines) {
+    string buffer;
+    char buf[160];
+    for (size_t i = 0; i < lines; ++i) {
+        double price = 43000.0 + (i % 1000) * 0.37;
+        double qty = 0.001 + (i % 97) * 0.0013;
+        int n = snprintf(buf, sizeof(buf), "%lld,BTCUSDT,%lld,%.8f,%.8f,%.8f,%.8f,%.8f\n",
+                         1700000000000LL + (long long)i, 3000000000LL + (long long)i,
+                         price, price, price, price, qty);
+        buffer.append(buf, n);
+    }
+    return buffer;
+}
+
+static bool same(const TickerData& a, const TickerData& b) {
+    return a.timestamp_ms == b.timestamp_ms && a.symbol_id == b.symbol_id && a.trade_id == b.trade_id &&
+           a.open == b.open && a.high == b.high && a.low == b.low && a.close == b.close &&
+           a.volume == b.volume;
+}
+
+int main(int argc, char** argv) {
+    size_t lines = argc > 1 ? stoul(argv[1]) : 360;
+    int rounds = argc > 2 ? stoi(argv[2]) : 20000;
+    string buffer = make_buffer(lines);
+    double total = static_cast<double>(lines) * rounds;
+
+    // Baseline: split lines and call the from_chars parser one by one
+    vector<TickerData> reference;
+    {
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            reference.clear();
+            size_t pos = 0;
+            while (pos < buffer.size()) {
+                size_t nl = buffer.find('\n', pos);
+                reference.emplace_back();
+                parseTickerData(string_view(buffer).substr(pos, nl - pos), reference.back());
+                pos = nl + 1;
+            }
+        }
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "per-line parseTickerData(string_view): " << (secs * 1e9 / total) << " ns/trade" << endl;
+    }
+
+    TickDecoder decoder;
+    for (auto kernel : {TickDecoder::Kernel::Scalar, TickDecoder::Kernel::SSE2, TickDecoder::Kernel::AVX2}) {
+        decoder.set_kernel(kernel);
+        if (decoder.kernel() != kernel) continue; // Not supported on this CPU
+
+        vector<TickerData> out;
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            out.clear();
+            decoder.decode(buffer, out);
+        }
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        size_t mismatches = out.size() == reference.size() ? 0 : out.size() + reference.size();
+        for (size_t i = 0; mismatches == 0 && i < out.size(); ++i) {
+            if (!same(out[i], reference[i])) ++mismatches;
+        }
+        cout << "TickDecoder[" << TickDecoder::kernel_name(kernel) << "]: " << (secs * 1e9 / total)
+             << " ns/trade, mismatches vs from_chars: " << mismatches << endl;
+    }
+    return 0;
+}
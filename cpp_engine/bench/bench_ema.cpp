@@ -0,0 +1,137 @@
+// File: /cpp_engine/bench/bench_ema.cpp
+// Microbenchmark: the former ProcessingThread::calculate_ema vs. fused EMA banks.
+
+#include "../include/Indicators.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// --- Legacy path, as it was in ProcessingThread before the indicator library ---
+
+struct LegacyEmaState {
+    double last_ema_value_20 = 0.0;
+    double last_ema_value_50 = 0.0;
+    bool is_first_ema_20 = true;
+    bool is_first_ema_50 = true;
+};
+
+static const int EMA_PERIOD_20 = 20;
+static const int EMA_PERIOD_50 = 50;
+
+static double calculate_ema(LegacyEmaState& state, double current_price, int period) {
+    double& last_ema_value = (period == EMA_PERIOD_20) ? state.last_ema_value_20 : state.last_ema_value_50;
+    bool& is_first_ema = (period == EMA_PERIOD_20) ? state.is_first_ema_20 : state.is_first_ema_50;
+
+    const double multiplier = 2.0 / (static_cast<double>(period) + 1.0);
+
+    double new_ema;
+    if (is_first_ema) {
+        new_ema = current_price;
+        is_first_ema = false;
+    } else {
+        new_ema = (current_price * multiplier) + (last_ema_value * (1.0 - multiplier));
+    }
+    last_ema_value = new_ema;
+    return new_ema;
+}
+
+static vector<TickerData> make_ticks(size_t count) {
+    vector<TickerData> ticks(count);
+    for (size_t i = 0; i < count; ++i) {
+        TickerData& t = ticks[i];
+        memset(&t, 0, sizeof(t));
+        t.timestamp_ms = 1700000000000LL + (long long)i;
+        t.trade_id = (long long)i;
+        t.open = t.high = t.low = t.close = 43000.0 + (i % 1000) * 0.37 - (i % 7) * 1.1;
+        t.volume = 0.001 + (i % 97) * 0.0013;
+    }
+    return ticks;
+}
+
+// Runs `step` over every tick; `step` writes the tick's EMA 20/50 into out[0..1]
+template <typename Fn>
+static void run(const char* name, const vector<TickerData>& ticks, int rounds, vector<double>& results, Fn&& make_step) {
+    results.assign(ticks.size() * 2, 0.0);
+    double secs = 0.0;
+    for (int r = 0; r < rounds; ++r) {
+        auto step = make_step(); // Fresh state each round
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < ticks.size(); ++i) {
+            step(ticks[i], &results[i * 2]);
+        }
+        secs += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    double total = static_cast<double>(ticks.size()) * rounds;
+    cout << name << ": " << (secs * 1e9 / total) << " ns/tick (EMA 20 + EMA 50)" << endl;
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? stoul(argv[1]) : 1000000;
+    int rounds = argc > 2 ? stoi(argv[2]) : 10;
+    vector<TickerData> ticks = make_ticks(count);
+    vector<double> reference, results;
+
+    run("legacy calculate_ema x2", ticks, rounds, reference, [] {
+        return [state = LegacyEmaState()](const TickerData& t, double* out) mutable {
+            out[0] = calculate_ema(state, t.close, EMA_PERIOD_20);
+            out[1] = calculate_ema(state, t.close, EMA_PERIOD_50);
+        };
+    });
+
+    auto check = [&](const char* name) {
+        size_t mismatches = 0;
+        for (size_t i = 0; i < results.size(); ++i) mismatches += results[i] != reference[i];
+        cout << "  " << name << " mismatches vs legacy: " << mismatches << endl;
+    };
+
+    run("Ema x2 (virtual Indicator)", ticks, rounds, results, [] {
+        vector<shared_ptr<Indicator>> emas = {make_shared<Ema>(20), make_shared<Ema>(50)};
+        return [emas](const TickerData& t, double* out) {
+            for (size_t k = 0; k < 2; ++k) {
+                emas[k]->update(t);
+                out[k] = emas[k]->value(0);
+            }
+        };
+    });
+    check("Ema x2");
+
+    run("RuntimeEmaBank{20, 50} (virtual Indicator)", ticks, rounds, results, [] {
+        shared_ptr<Indicator> bank = make_shared<RuntimeEmaBank>(vector<int>{20, 50});
+        return [bank](const TickerData& t, double* out) {
+            bank->update(t);
+            out[0] = bank->value(0);
+            out[1] = bank->value(1);
+        };
+    });
+    check("RuntimeEmaBank");
+
+    run("EmaBank<20, 50> (virtual Indicator)", ticks, rounds, results, [] {
+        shared_ptr<Indicator> bank = make_ema_bank({20, 50});
+        return [bank](const TickerData& t, double* out) {
+            bank->update(t);
+            out[0] = bank->value(0);
+            out[1] = bank->value(1);
+        };
+    });
+    check("EmaBank<20, 50> virtual");
+
+    run("EmaBank<20, 50> (update_outputs, as in ProcessingThread)", ticks, rounds, results, [] {
+        shared_ptr<Indicator> bank = make_ema_bank({20, 50});
+        return [bank](const TickerData& t, double* out) { bank->update_outputs(t, out); };
+    });
+    check("EmaBank<20, 50> update_outputs");
+
+    run("EmaBank<20, 50> (direct)", ticks, rounds, results, [] {
+        return [bank = EmaBank<20, 50>()](const TickerData& t, double* out) mutable {
+            bank.add(t.close);
+            out[0] = bank.current(0);
+            out[1] = bank.current(1);
+        };
+    });
+    check("EmaBank<20, 50> direct");
+    return 0;
+}
@@ -0,0 +1,58 @@
+// File: /cpp_engine/bench/bench_parse.cpp
+// Microbenchmark: legacy stringstream parser vs. the std::from_chars fast path.
+
+#include "../include/TickerData.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Lines shaped like binance_data_fetcher.py output ({price:.8f})
+static vector<string> make_lines(size_t count) {
+    vector<string> lines;
+    lines.reserve(count);
+    char buf[160];
+    for (size_t i = 0; i < count; ++i) {
+        double price = 43000.0 + (i % 1000) * 0.37;
+        double qty = 0.001 + (i % 97) * 0.0013;
+        snprintf(buf, sizeof(buf), "%lld,BTCUSDT,%lld,%.8f,%.8f,%.8f,%.8f,%.8f",
+                 1700000000000LL + (long long)i, 3000000000LL + (long long)i,
+                 price, price, price, price, qty);
+        lines.emplace_back(buf);
+    }
+    return lines;
+}
+
+template <typename Fn>
+static void run(const char* name, const vector<string>& lines, int rounds, Fn&& parse_one) {
+    double checksum = 0.0;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const auto& line : lines) {
+            checksum += parse_one(line);
+        }
+    }
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    double total = static_cast<double>(lines.size()) * rounds;
+    cout << name << ": " << static_cast<long long>(total / secs) << " trades/sec ("
+         << (secs * 1e9 / total) << " ns/trade, checksum " << checksum << ")" << endl;
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? stoul(argv[1]) : 200000;
+    int rounds = argc > 2 ? stoi(argv[2]) : 5;
+    vector<string> lines = make_lines(count);
+
+    run("legacy parseTickerData(const std::string&)", lines, rounds, [](const string& line) {
+        return parseTickerData(line).close;
+    });
+
+    TickerData out;
+    run("parseTickerData(std::string_view, TickerData&)", lines, rounds, [&out](const string& line) {
+        return parseTickerData(string_view(line), out) == ParseStatus::Ok ? out.close : 0.0;
+    });
+    return 0;
+}
@@ -0,0 +1,191 @@
+// File: /cpp_engine/bench/bench_partition.cpp
+// One SQLite file vs. per-day partitions for several days of trades: ingest rate and worst
+// commit, the cost of opening a fresh partition (what the background opener takes off the
+// writer at rollover), loading one day of trades, and dropping the oldest day.
+// Usage: bench_partition [trades] [days] [schema.sql]
+
+#include "../include/Constants.h"
+#include "../include/Persistence.h"
+#include "../include/PartitionedDatabase.h"
+#include "../include/UtcTime.h"
+#include "../include/sqlite3.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char* BENCH_DB = "bench_partition.db";
+static const char* BENCH_PARTITION_DIR = "bench_partitions";
+static const long long FIRST_DAY_MS = 1700006400000LL; // 2023-11-15 00:00 UTC
+
+static vector<TickerData> make_trades(size_t count, int days) {
+    vector<TickerData> trades(count);
+    SymbolId symbol_id = intern_symbol("BTCUSDT");
+    long long spacing = max(1LL, days * DAY_MS / (long long)max<size_t>(count, 1));
+    for (size_t i = 0; i < count; ++i) {
+        TickerData& t = trades[i];
+        t.timestamp_ms = FIRST_DAY_MS + (long long)i * spacing;
+        t.symbol_id = symbol_id;
+        t.flags = 0;
+        t.trade_id = 3000000000LL + (long long)i;
+        t.open = t.high = t.low = t.close = 43000.0 + (i % 1000) * 0.37;
+        t.volume = 0.001 + (i % 97) * 0.0013;
+    }
+    return trades;
+}
+
+static bool create_db(const string& schema_path) {
+    remove(BENCH_DB);
+    ifstream in(schema_path);
+    if (!in) {
+        cerr << "Cannot read schema: " << schema_path << endl;
+        return false;
+    }
+    stringstream schema;
+    schema << in.rdbuf();
+
+    sqlite3* db;
+    sqlite3_open(BENCH_DB, &db);
+    bool ok = sqlite3_exec(db, schema.str().c_str(), 0, 0, 0) == SQLITE_OK;
+    sqlite3_close(db);
+    return ok;
+}
+
+// Commits every BATCH_SIZE trades like the writer; returns the slowest commit in ms
+static double write_batches(PersistenceBackend& backend, const vector<TickerData>& trades) {
+    vector<TickerData> batch;
+    vector<MetricRow> metrics;
+    double worst_ms = 0;
+    for (size_t i = 0; i < trades.size(); i += BATCH_SIZE) {
+        auto start = chrono::steady_clock::now();
+        batch.assign(trades.begin() + i, trades.begin() + min(trades.size(), i + BATCH_SIZE));
+        metrics.clear();
+        for (const auto& t : batch) {
+            metrics.push_back(MetricRow{t.timestamp_ms, t.trade_id, t.symbol_id, t.close, t.close, t.close, t.close});
+        }
+        backend.begin_transaction();
+        backend.insert_raw_batch(batch);
+        backend.insert_metrics_batch(metrics);
+        backend.commit_transaction();
+        worst_ms = max(worst_ms, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+    }
+    return worst_ms;
+}
+
+static void report_ingest(const char* name, size_t rows, double secs, double worst_ms) {
+    cout << name << ": " << static_cast<long long>(rows / secs) << " trades/sec, slowest commit " << worst_ms << " ms" << endl;
+}
+
+// The single file's version of a one-day load_ticks: same query, plus the time range
+static size_t load_day(sqlite3* db, long long day_ms) {
+    sqlite3_stmt* stmt;
+    sqlite3_prepare_v2(db, "SELECT open_time_ms, trade_id, close_price, volume FROM raw_ohlcv_data "
+                           "WHERE symbol_id = (SELECT symbol_id FROM symbols WHERE symbol = 'BTCUSDT') "
+                           "AND open_time_ms BETWEEN ? AND ? ORDER BY open_time_ms, trade_id;",
+                       -1, &stmt, 0);
+    sqlite3_bind_int64(stmt, 1, day_ms);
+    sqlite3_bind_int64(stmt, 2, day_ms + DAY_MS - 1);
+    TickColumns out;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        out.timestamp_ms.push_back(sqlite3_column_int64(stmt, 0));
+        out.trade_id.push_back(sqlite3_column_int64(stmt, 1));
+        out.close.push_back(sqlite3_column_double(stmt, 2));
+        out.volume.push_back(sqlite3_column_double(stmt, 3));
+    }
+    sqlite3_finalize(stmt);
+    return out.size();
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? stoul(argv[1]) : 500000;
+    int days = argc > 2 ? max(2, atoi(argv[2])) : 5;
+    string schema_path = argc > 3 ? argv[3] : "../../db_setup/schema.sql";
+    vector<TickerData> trades = make_trades(count, days);
+    long long last_day = FIRST_DAY_MS + (days - 1) * DAY_MS;
+    streambuf* saved;
+
+    // Single file
+    if (!create_db(schema_path)) return 1;
+    {
+        PersistenceManager manager;
+        manager.open_db(BENCH_DB);
+        saved = cout.rdbuf(nullptr); // Silence per-commit logging
+        auto start = chrono::steady_clock::now();
+        double worst_ms = write_batches(manager, trades);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        manager.close_db();
+        cout.rdbuf(saved);
+        report_ingest("single file", count, secs, worst_ms);
+
+        sqlite3* db;
+        sqlite3_open(BENCH_DB, &db);
+        start = chrono::steady_clock::now();
+        size_t rows = load_day(db, last_day);
+        cout << "single file: last day's " << rows << " trades loaded in "
+             << chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() << " ms" << endl;
+
+        start = chrono::steady_clock::now();
+        string sql = "DELETE FROM raw_ohlcv_data WHERE open_time_ms < " + to_string(FIRST_DAY_MS + DAY_MS) +
+                     "; DELETE FROM aggregated_metrics WHERE open_time_ms < " + to_string(FIRST_DAY_MS + DAY_MS) + ";";
+        sqlite3_exec(db, sql.c_str(), 0, 0, 0);
+        cout << "single file: oldest day deleted in "
+             << chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() << " ms" << endl;
+        sqlite3_close(db);
+    }
+
+    // Per-day partitions, catalog holding only the schema
+    if (!create_db(schema_path)) return 1;
+    fs::remove_all(BENCH_PARTITION_DIR);
+    {
+        PersistenceManager catalog;
+        saved = cout.rdbuf(nullptr);
+        catalog.open_db(BENCH_DB);
+        PartitionedDatabase partitioned(catalog, DAY_MS, BENCH_PARTITION_DIR);
+        partitioned.open();
+        auto start = chrono::steady_clock::now();
+        double worst_ms = write_batches(partitioned, trades);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        partitioned.close();
+
+        // What a rollover costs the writer without the background opener
+        string schema;
+        catalog.table_schema(PARTITIONED_TABLES, schema);
+        PersistenceManager fresh;
+        auto open_start = chrono::steady_clock::now();
+        fresh.open_db(partitioned.partition_path(last_day + 10 * DAY_MS), DbConfig(), schema);
+        double open_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - open_start).count();
+        fresh.close_db();
+        fs::remove(partitioned.partition_path(last_day + 10 * DAY_MS));
+
+        // Opening the reader (ATTACH) is part of the cost
+        PersistenceManager reader;
+        TickColumns ticks;
+        auto load_start = chrono::steady_clock::now();
+        partitioned.open_reader(reader, last_day, last_day + DAY_MS - 1);
+        reader.load_ticks("BTCUSDT", ticks);
+        double load_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - load_start).count();
+        reader.close_db();
+        cout.rdbuf(saved);
+        report_ingest("partitioned", count, secs, worst_ms);
+        cout << "partitioned: opening a fresh partition inline costs " << open_ms << " ms" << endl;
+        cout << "partitioned: last day's " << ticks.size() << " trades loaded in " << load_ms << " ms" << endl;
+
+        start = chrono::steady_clock::now();
+        for (const char* suffix : {"", "-wal", "-shm"}) fs::remove(partitioned.partition_path(FIRST_DAY_MS) + suffix);
+        cout << "partitioned: oldest day deleted in "
+             << chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() << " ms" << endl;
+        catalog.close_db();
+    }
+
+    fs::remove_all(BENCH_PARTITION_DIR);
+    remove(BENCH_DB);
+    return 0;
+}
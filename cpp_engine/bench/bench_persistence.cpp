@@ -0,0 +1,199 @@
+// File: /cpp_engine/bench/bench_persistence.cpp
+// Rows/sec for 100k trades: prepare-per-row (previous PersistenceManager) vs. cached statements
+// vs. multi-row batch inserts vs. the columnar tick store, plus the time to load the trades back.
+// Usage: bench_persistence [trades] [schema.sql]
+
+#include "../include/Constants.h"
+#include "../include/Persistence.h"
+#include "../include/ColumnarTickStore.h"
+#include "../include/sqlite3.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static const char* BENCH_DB = "bench_persistence.db";
+static const char* BENCH_TICK_DIR = "bench_ticks";
+
+static vector<TickerData> make_trades(size_t count) {
+    vector<TickerData> trades(count);
+    SymbolId symbol_id = intern_symbol("BTCUSDT");
+    for (size_t i = 0; i < count; ++i) {
+        TickerData& t = trades[i];
+        t.timestamp_ms = 1700000000000LL + (long long)i;
+        t.symbol_id = symbol_id;
+        t.flags = 0;
+        t.trade_id = 3000000000LL + (long long)i;
+        t.open = t.high = t.low = t.close = 43000.0 + (i % 1000) * 0.37;
+        t.volume = 0.001 + (i % 97) * 0.0013;
+    }
+    return trades;
+}
+
+static bool create_db(const string& schema_path) {
+    remove(BENCH_DB);
+    ifstream in(schema_path);
+    if (!in) {
+        cerr << "Cannot read schema: " << schema_path << endl;
+        return false;
+    }
+    stringstream schema;
+    schema << in.rdbuf();
+
+    sqlite3* db;
+    sqlite3_open(BENCH_DB, &db);
+    bool ok = sqlite3_exec(db, schema.str().c_str(), 0, 0, 0) == SQLITE_OK;
+    sqlite3_close(db);
+    return ok;
+}
+
+// The pre-caching code path: prepare + finalize around every row (`symbol_key`: symbols.symbol_id)
+static void insert_uncached(sqlite3* db, const TickerData& data, long long symbol_key) {
+    sqlite3_stmt* stmt;
+    sqlite3_prepare_v2(db, "INSERT OR IGNORE INTO raw_ohlcv_data (symbol_id, open_time_ms, trade_id, open_price, high_price, low_price, close_price, volume, ingested_ms) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);", -1, &stmt, 0);
+    sqlite3_bind_int64(stmt, 1, symbol_key);
+    sqlite3_bind_int64(stmt, 2, data.timestamp_ms);
+    sqlite3_bind_int64(stmt, 3, data.trade_id);
+    sqlite3_bind_double(stmt, 4, data.open);
+    sqlite3_bind_double(stmt, 5, data.high);
+    sqlite3_bind_double(stmt, 6, data.low);
+    sqlite3_bind_double(stmt, 7, data.close);
+    sqlite3_bind_double(stmt, 8, data.volume);
+    sqlite3_bind_int64(stmt, 9, data.timestamp_ms);
+    sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    sqlite3_prepare_v2(db, "INSERT OR IGNORE INTO aggregated_metrics (symbol_id, open_time_ms, trade_id, vwap, simple_average, ema_20, ema_50) VALUES (?, ?, ?, ?, ?, ?, ?);", -1, &stmt, 0);
+    sqlite3_bind_int64(stmt, 1, symbol_key);
+    sqlite3_bind_int64(stmt, 2, data.timestamp_ms);
+    sqlite3_bind_int64(stmt, 3, data.trade_id);
+    for (int col = 4; col <= 7; ++col) sqlite3_bind_double(stmt, col, data.close);
+    sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+}
+
+// The connection settings PersistenceManager::open_db applies, so the baseline differs from
+// the cached variants only in statement handling. Without the background checkpointer the
+// WAL is checkpointed at SQLite's default 1000 pages, as open_db does in that case.
+static void apply_config(sqlite3* db, const DbConfig& config) {
+    sqlite3_busy_timeout(db, config.busy_timeout_ms);
+    string sql = "PRAGMA page_size = " + to_string(config.page_size) + "; PRAGMA journal_mode = " + config.journal_mode +
+                 "; PRAGMA synchronous = " + config.synchronous + "; PRAGMA cache_size = -" + to_string(config.cache_size_kib) +
+                 "; PRAGMA temp_store = " + config.temp_store + "; PRAGMA wal_autocheckpoint = 1000; PRAGMA mmap_size = " +
+                 to_string(config.mmap_size) + ";";
+    sqlite3_exec(db, sql.c_str(), 0, 0, 0);
+}
+
+static void report(const char* name, size_t rows, chrono::steady_clock::time_point start) {
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << name << ": " << static_cast<long long>(rows / secs) << " trades/sec (" << secs << " s)" << endl;
+}
+
+// Ingest loop shared by the last two variants, committing every BATCH_SIZE trades
+static void write_batches(PersistenceBackend& backend, const vector<TickerData>& trades) {
+    vector<TickerData> batch;
+    vector<MetricRow> metrics;
+    for (size_t i = 0; i < trades.size(); i += BATCH_SIZE) {
+        batch.assign(trades.begin() + i, trades.begin() + min(trades.size(), i + BATCH_SIZE));
+        metrics.clear();
+        for (const auto& t : batch) {
+            metrics.push_back(MetricRow{t.timestamp_ms, t.trade_id, t.symbol_id, t.close, t.close, t.close, t.close});
+        }
+        backend.begin_transaction();
+        backend.insert_raw_batch(batch);
+        backend.insert_metrics_batch(metrics);
+        backend.commit_transaction();
+    }
+}
+
+static void report_load(const char* name, PersistenceBackend& backend) {
+    TickColumns ticks;
+    auto start = chrono::steady_clock::now();
+    backend.load_ticks("BTCUSDT", ticks);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << name << ": loaded " << ticks.size() << " trades in " << ms << " ms" << endl;
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? stoul(argv[1]) : 100000;
+    string schema_path = argc > 2 ? argv[2] : "../../db_setup/schema.sql";
+    vector<TickerData> trades = make_trades(count);
+
+    // Both variants commit every BATCH_SIZE trades, like ProcessingThread
+    if (!create_db(schema_path)) return 1;
+    {
+        sqlite3* db;
+        sqlite3_open(BENCH_DB, &db);
+        apply_config(db, DbConfig());
+        sqlite3_exec(db, "INSERT INTO symbols (symbol_id, symbol) VALUES (1, 'BTCUSDT');", 0, 0, 0);
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < count; i += BATCH_SIZE) {
+            sqlite3_exec(db, "BEGIN TRANSACTION;", 0, 0, 0);
+            for (size_t j = i; j < count && j < i + BATCH_SIZE; ++j) insert_uncached(db, trades[j], 1);
+            sqlite3_exec(db, "COMMIT;", 0, 0, 0);
+        }
+        report("prepare per row", count, start);
+        sqlite3_close(db);
+    }
+
+    if (!create_db(schema_path)) return 1;
+    {
+        PersistenceManager manager;
+        manager.open_db(BENCH_DB);
+        streambuf* saved = cout.rdbuf(nullptr); // Silence per-commit logging while timing
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < count; i += BATCH_SIZE) {
+            manager.begin_transaction();
+            for (size_t j = i; j < count && j < i + BATCH_SIZE; ++j) {
+                const TickerData& t = trades[j];
+                manager.insert_raw_data(t);
+                manager.insert_metrics(t.timestamp_ms, t.trade_id, string(t.symbol()), t.close, t.close, t.close, t.close);
+            }
+            manager.commit_transaction();
+        }
+        cout.rdbuf(saved);
+        report("cached statements", count, start);
+    }
+
+    if (!create_db(schema_path)) return 1;
+    {
+        PersistenceManager manager;
+        manager.open_db(BENCH_DB);
+        streambuf* saved = cout.rdbuf(nullptr);
+        auto start = chrono::steady_clock::now();
+        write_batches(manager, trades);
+        cout.rdbuf(saved);
+        report("multi-row batch", count, start);
+        report_load("multi-row batch", manager);
+    }
+
+    // Raw trades to columnar segments, metrics still to SQLite
+    if (!create_db(schema_path)) return 1;
+    std::filesystem::remove_all(BENCH_TICK_DIR);
+    {
+        PersistenceManager manager;
+        manager.open_db(BENCH_DB);
+        ColumnarTickStore store(manager, BENCH_TICK_DIR);
+        streambuf* saved = cout.rdbuf(nullptr);
+        store.open();
+        auto start = chrono::steady_clock::now();
+        write_batches(store, trades);
+        cout.rdbuf(saved);
+        report("columnar tick store", count, start);
+        report_load("columnar tick store", store);
+        saved = cout.rdbuf(nullptr);
+        store.close();
+        cout.rdbuf(saved);
+    }
+
+    std::filesystem::remove_all(BENCH_TICK_DIR);
+    remove(BENCH_DB);
+    return 0;
+}
@@ -0,0 +1,66 @@
+// File: /cpp_engine/bench/bench_queue.cpp
+// Contended throughput and hand-off latency: LockedQueue (mutex) vs. SafeQueue (lock-free MPSC ring).
+
+#include "../include/LockedQueue.h"
+#include "../include/SafeQueue.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static long long now_ns() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Producers stamp each tick with its push time; the consumer records push -> pop latency
+template <typename Queue>
+static void run(const char* name, int producers, size_t per_producer) {
+    Queue queue;
+    vector<long long> latencies;
+    latencies.reserve(producers * per_producer);
+
+    long long start = now_ns();
+    thread consumer([&] {
+        size_t expected = producers * per_producer;
+        for (size_t i = 0; i < expected; ++i) {
+            optional<TickerData> data = queue.pop();
+            if (!data) break;
+            latencies.push_back(now_ns() - data->timestamp_ms);
+        }
+    });
+
+    vector<thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, per_producer, p] {
+            TickerData tick{};
+            tick.symbol_id = intern_symbol("BTCUSDT");
+            for (size_t i = 0; i < per_producer; ++i) {
+                tick.trade_id = static_cast<long long>(p * per_producer + i);
+                tick.timestamp_ms = now_ns();
+                queue.push(tick);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    consumer.join();
+    double secs = (now_ns() - start) / 1e9;
+
+    sort(latencies.begin(), latencies.end());
+    auto pct = [&](double q) { return latencies[min(latencies.size() - 1, static_cast<size_t>(q * latencies.size()))]; };
+    cout << name << " producers=" << producers
+         << " throughput=" << static_cast<long long>(latencies.size() / secs) << " items/s"
+         << " p50=" << pct(0.50) << "ns p99=" << pct(0.99) << "ns p99.9=" << pct(0.999) << "ns" << endl;
+}
+
+int main(int argc, char** argv) {
+    size_t total = argc > 1 ? stoul(argv[1]) : 1600000;
+    for (int producers : {1, 4, 16}) {
+        run<LockedQueue<TickerData>>("LockedQueue", producers, total / producers);
+        run<SafeQueue<TickerData>>("SafeQueue  ", producers, total / producers);
+    }
+    return 0;
+}
@@ -0,0 +1,269 @@
+// File: /cpp_engine/bench/bench_schema.cpp
+// Schema version 0 (text symbol in every row, rowid tables with symbol/time indexes, strftime
+// ingestion timestamp) vs. version 1 (symbol ids, WITHOUT ROWID tables clustered by
+// (symbol_id, open_time_ms, trade_id), integer ingested_ms): insert rate of interleaved
+// symbols, one symbol's time-range scan, file size, and migrating the v0 file at open_db,
+// both as last written by the engine and as created by the original schema.sql.
+// Usage: bench_schema [trades] [schema.sql]
+
+#include "../include/Constants.h"
+#include "../include/Persistence.h"
+#include "../include/sqlite3.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char* V0_DB = "bench_schema_v0.db";
+static const char* V1_DB = "bench_schema_v1.db";
+static const char* BASELINE_DB = "bench_schema_baseline.db";
+static const long long FIRST_MS = 1700006400000LL; // 2023-11-15 00:00 UTC
+static const char* SYMBOLS[] = {"BTCUSDT", "ETHUSDT", "SOLUSDT", "BNBUSDT"};
+static const int SYMBOL_COUNT = 4;
+static const int ROWS_PER_INSERT = 128;
+static const int SCANS = 50;
+static const long long SCAN_MS = 60 * 60 * 1000LL;
+
+// The original db_setup/schema.sql: trades and metrics only
+static const char* BASELINE_SCHEMA = R"(
+CREATE TABLE raw_ohlcv_data (
+    trade_id INTEGER NOT NULL, symbol TEXT NOT NULL, open_time_ms INTEGER NOT NULL,
+    open_price REAL NOT NULL, high_price REAL NOT NULL, low_price REAL NOT NULL, close_price REAL NOT NULL, volume REAL NOT NULL,
+    ingestion_timestamp TEXT DEFAULT (strftime('%Y-%m-%d %H:%M:%S', 'now', 'localtime')),
+    PRIMARY KEY (trade_id, symbol));
+CREATE INDEX idx_raw_symbol ON raw_ohlcv_data (symbol);
+CREATE INDEX idx_raw_time ON raw_ohlcv_data (open_time_ms);
+CREATE TABLE aggregated_metrics (
+    trade_id INTEGER NOT NULL, symbol TEXT NOT NULL, open_time_ms INTEGER NOT NULL,
+    vwap REAL, simple_average REAL, ema_20 REAL, ema_50 REAL,
+    PRIMARY KEY (trade_id, symbol));
+CREATE INDEX idx_metrics_symbol ON aggregated_metrics (symbol);
+CREATE INDEX idx_metrics_time ON aggregated_metrics (open_time_ms);
+)";
+
+// Tables schema.sql gained before user_version existed; BASELINE_SCHEMA plus these is v0
+static const char* V0_ADDED_TABLES = R"(
+CREATE TABLE ohlcv_bars (
+    symbol TEXT NOT NULL, interval_ms INTEGER NOT NULL, open_time_ms INTEGER NOT NULL,
+    open_price REAL NOT NULL, high_price REAL NOT NULL, low_price REAL NOT NULL, close_price REAL NOT NULL,
+    volume REAL NOT NULL, quote_volume REAL NOT NULL, trade_count INTEGER NOT NULL,
+    PRIMARY KEY (symbol, interval_ms, open_time_ms));
+CREATE TABLE indicator_values (
+    trade_id INTEGER NOT NULL, symbol TEXT NOT NULL, open_time_ms INTEGER NOT NULL, name TEXT NOT NULL, value REAL,
+    PRIMARY KEY (trade_id, symbol, name));
+CREATE TABLE journal_state (id INTEGER PRIMARY KEY CHECK (id = 0), committed_sequence INTEGER NOT NULL);
+)";
+
+struct Trade {
+    long long time_ms;
+    long long trade_id;
+    int symbol;      // Index into SYMBOLS; symbol_id is symbol + 1
+    double price;
+    double volume;
+};
+
+// One trade per symbol in turn, 10 ms apart, each symbol with its own trade id sequence
+static vector<Trade> make_trades(size_t count) {
+    vector<Trade> trades(count);
+    for (size_t i = 0; i < count; ++i) {
+        Trade& t = trades[i];
+        t.time_ms = FIRST_MS + (long long)i * 10;
+        t.symbol = (int)(i % SYMBOL_COUNT);
+        t.trade_id = 3000000000LL + (long long)(i / SYMBOL_COUNT);
+        t.price = 43000.0 + (i % 1000) * 0.37;
+        t.volume = 0.001 + (i % 97) * 0.0013;
+    }
+    return trades;
+}
+
+static bool create_db(const char* path, const string& schema) {
+    for (const char* suffix : {"", "-wal", "-shm"}) fs::remove(string(path) + suffix);
+    sqlite3* db;
+    sqlite3_open(path, &db);
+    bool ok = sqlite3_exec(db, schema.c_str(), 0, 0, 0) == SQLITE_OK;
+    if (!ok) cerr << "Schema failed: " << sqlite3_errmsg(db) << endl;
+    sqlite3_close(db);
+    return ok;
+}
+
+static string multi_row(const string& head, int params) {
+    string row = "(?";
+    for (int i = 1; i < params; ++i) row += ", ?";
+    row += ")";
+    string sql = head;
+    for (int i = 0; i < ROWS_PER_INSERT; ++i) sql += (i ? ", " : " ") + row;
+    return sql + ";";
+}
+
+// Writes trades and their metrics the way the writer does: BATCH_SIZE trades per transaction,
+// ROWS_PER_INSERT rows per prepared statement. Returns trades/sec.
+static double insert_trades(const char* path, bool v1, const vector<Trade>& trades) {
+    sqlite3* db;
+    sqlite3_open(path, &db);
+    sqlite3_exec(db, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;", 0, 0, 0);
+    if (v1) {
+        for (int s = 0; s < SYMBOL_COUNT; ++s) {
+            string sql = "INSERT INTO symbols (symbol_id, symbol) VALUES (" + to_string(s + 1) + ", '" + SYMBOLS[s] + "');";
+            sqlite3_exec(db, sql.c_str(), 0, 0, 0);
+        }
+    }
+    string raw_sql = v1 ? multi_row("INSERT OR IGNORE INTO raw_ohlcv_data (symbol_id, open_time_ms, trade_id, open_price, high_price, low_price, close_price, volume, ingested_ms) VALUES", 9)
+                        : multi_row("INSERT OR IGNORE INTO raw_ohlcv_data (open_time_ms, trade_id, symbol, open_price, high_price, low_price, close_price, volume) VALUES", 8);
+    string metric_sql = multi_row(v1 ? "INSERT OR IGNORE INTO aggregated_metrics (symbol_id, open_time_ms, trade_id, vwap, simple_average, ema_20, ema_50) VALUES"
+                                     : "INSERT OR IGNORE INTO aggregated_metrics (open_time_ms, trade_id, symbol, vwap, simple_average, ema_20, ema_50) VALUES", 7);
+    sqlite3_stmt* raw;
+    sqlite3_stmt* metric;
+    sqlite3_prepare_v2(db, raw_sql.c_str(), -1, &raw, 0);
+    sqlite3_prepare_v2(db, metric_sql.c_str(), -1, &metric, 0);
+
+    // v0 rows start (open_time_ms, trade_id, symbol), v1 rows (symbol_id, open_time_ms, trade_id)
+    auto bind_key = [&](sqlite3_stmt* stmt, int col, const Trade& t) {
+        if (v1) {
+            sqlite3_bind_int64(stmt, col, t.symbol + 1);
+            sqlite3_bind_int64(stmt, col + 1, t.time_ms);
+            sqlite3_bind_int64(stmt, col + 2, t.trade_id);
+        } else {
+            sqlite3_bind_int64(stmt, col, t.time_ms);
+            sqlite3_bind_int64(stmt, col + 1, t.trade_id);
+            sqlite3_bind_text(stmt, col + 2, SYMBOLS[t.symbol], -1, SQLITE_STATIC);
+        }
+    };
+
+    size_t usable = trades.size() - trades.size() % ROWS_PER_INSERT;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < usable; i += BATCH_SIZE) {
+        sqlite3_exec(db, "BEGIN TRANSACTION;", 0, 0, 0);
+        long long ingested_ms = FIRST_MS + (long long)i;
+        for (size_t j = i; j < usable && j < i + BATCH_SIZE; j += ROWS_PER_INSERT) {
+            int raw_col = 1, metric_col = 1;
+            for (size_t k = j; k < j + ROWS_PER_INSERT; ++k) {
+                const Trade& t = trades[k];
+                bind_key(raw, raw_col, t);
+                for (int c = 3; c < 7; ++c) sqlite3_bind_double(raw, raw_col + c, t.price);
+                sqlite3_bind_double(raw, raw_col + 7, t.volume);
+                if (v1) sqlite3_bind_int64(raw, raw_col + 8, ingested_ms);
+                raw_col += v1 ? 9 : 8;
+
+                bind_key(metric, metric_col, t);
+                for (int c = 3; c < 7; ++c) sqlite3_bind_double(metric, metric_col + c, t.price);
+                metric_col += 7;
+            }
+            sqlite3_step(raw);
+            sqlite3_reset(raw);
+            sqlite3_step(metric);
+            sqlite3_reset(metric);
+        }
+        sqlite3_exec(db, "COMMIT;", 0, 0, 0);
+    }
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    sqlite3_finalize(raw);
+    sqlite3_finalize(metric);
+    sqlite3_exec(db, "PRAGMA wal_checkpoint(TRUNCATE);", 0, 0, 0);
+    sqlite3_close(db);
+    return usable / secs;
+}
+
+// SCANS one-hour windows of one symbol's trades (what recompute and the analyzer read);
+// returns the average ms per window and the rows seen
+static double scan_windows(const char* path, bool v1, size_t count, size_t& rows) {
+    sqlite3* db;
+    sqlite3_open(path, &db);
+    sqlite3_stmt* stmt;
+    const char* sql = v1 ? "SELECT open_time_ms, trade_id, close_price, volume FROM raw_ohlcv_data "
+                           "WHERE symbol_id = (SELECT symbol_id FROM symbols WHERE symbol = ?1) "
+                           "AND open_time_ms BETWEEN ?2 AND ?3 ORDER BY open_time_ms, trade_id;"
+                         : "SELECT open_time_ms, trade_id, close_price, volume FROM raw_ohlcv_data "
+                           "WHERE symbol = ?1 AND open_time_ms BETWEEN ?2 AND ?3 ORDER BY open_time_ms, trade_id;";
+    sqlite3_prepare_v2(db, sql, -1, &stmt, 0);
+    long long span_ms = max(1LL, (long long)count * 10 - SCAN_MS);
+    rows = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < SCANS; ++i) {
+        long long from = FIRST_MS + (span_ms * i) / SCANS;
+        sqlite3_bind_text(stmt, 1, SYMBOLS[i % SYMBOL_COUNT], -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 2, from);
+        sqlite3_bind_int64(stmt, 3, from + SCAN_MS - 1);
+        double sum = 0;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            sum += sqlite3_column_double(stmt, 2) * sqlite3_column_double(stmt, 3);
+            ++rows;
+        }
+        sqlite3_reset(stmt);
+        if (sum < 0) cout << sum; // Keep the loop
+    }
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / SCANS;
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return ms;
+}
+
+// The engine's own upgrade path: open_db on a pre-v1 file, then the optional --vacuum rewrite
+static bool migrate(const char* path, const char* name, size_t count) {
+    streambuf* saved = cout.rdbuf(nullptr);
+    PersistenceManager manager;
+    auto start = chrono::steady_clock::now();
+    bool migrated = manager.open_db(path) && PersistenceManager::schema_version(path) == SCHEMA_VERSION;
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    uintmax_t size = fs::file_size(path);
+    start = chrono::steady_clock::now();
+    bool vacuumed = migrated && manager.vacuum();
+    double vacuum_secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    manager.close_db();
+    cout.rdbuf(saved);
+    if (!migrated) {
+        cerr << "Migrating the " << name << " file failed" << endl;
+        return false;
+    }
+    cout << "migrating " << name << " -> v1 at open_db: " << secs << " s (" << static_cast<long long>(2 * count / secs)
+         << " rows/sec), " << size / (1024 * 1024) << " MB";
+    if (vacuumed) cout << "; --vacuum " << vacuum_secs << " s, " << fs::file_size(path) / (1024 * 1024) << " MB";
+    cout << endl;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? stoul(argv[1]) : 1000000;
+    string schema_path = argc > 2 ? argv[2] : "../../db_setup/schema.sql";
+    ifstream in(schema_path);
+    if (!in) {
+        cerr << "Cannot read schema: " << schema_path << endl;
+        return 1;
+    }
+    stringstream v1_schema;
+    v1_schema << in.rdbuf();
+    vector<Trade> trades = make_trades(count);
+
+    if (!create_db(V0_DB, string(BASELINE_SCHEMA) + V0_ADDED_TABLES) || !create_db(V1_DB, v1_schema.str())) return 1;
+    double v0_rate = insert_trades(V0_DB, false, trades);
+    double v1_rate = insert_trades(V1_DB, true, trades);
+    cout << "insert, " << SYMBOL_COUNT << " interleaved symbols: v0 " << static_cast<long long>(v0_rate)
+         << " trades/sec, v1 " << static_cast<long long>(v1_rate) << " trades/sec" << endl;
+
+    size_t v0_rows, v1_rows;
+    double v0_ms = scan_windows(V0_DB, false, count, v0_rows);
+    double v1_ms = scan_windows(V1_DB, true, count, v1_rows);
+    cout << "one symbol, one hour (" << v1_rows / SCANS << " trades): v0 " << v0_ms << " ms, v1 " << v1_ms << " ms"
+         << (v0_rows == v1_rows ? "" : " (ROW COUNTS DIFFER)") << endl;
+
+    uintmax_t v0_size = fs::file_size(V0_DB), v1_size = fs::file_size(V1_DB);
+    cout << "file size: v0 " << v0_size / (1024 * 1024) << " MB, v1 " << v1_size / (1024 * 1024) << " MB" << endl;
+
+    // A DB from the original schema.sql has no ohlcv_bars / indicator_values to migrate
+    if (!create_db(BASELINE_DB, BASELINE_SCHEMA)) return 1;
+    insert_trades(BASELINE_DB, false, trades);
+    bool ok = migrate(V0_DB, "v0", count);
+    ok = migrate(BASELINE_DB, "original schema.sql", count) && ok;
+
+    for (const char* path : {V0_DB, V1_DB, BASELINE_DB}) {
+        for (const char* suffix : {"", "-wal", "-shm"}) fs::remove(string(path) + suffix);
+    }
+    return ok ? 0 : 1;
+}
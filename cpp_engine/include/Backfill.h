@@ -0,0 +1,33 @@
+// File: /cpp_engine/include/Backfill.h
+
+#ifndef BACKFILL_H
+#define BACKFILL_H
+
+#include <string>
+#include "Persistence.h"
+#include "TickJournal.h"
+#include "TickSink.h"
+
+/**
+ * @brief Recomputes aggregated_metrics for one symbol from its stored trades
+ * (raw_ohlcv_data, or the columnar segments with --tick-store columnar).
+ *
+ * Loads the symbol's trades into columns, runs the BatchIndicators kernels (session
+ * VWAP, SMA 20, EMA 20, EMA 50: the metrics columns of DEFAULT_INDICATORS) over the
+ * whole series and overwrites the existing rows in one transaction. Run it with the
+ * engine stopped; trades are taken in (open_time_ms, trade_id) order.
+ */
+bool recompute_metrics(PersistenceBackend& db, const std::string& symbol);
+
+/**
+ * @brief Replays the tick journal in `directory` from sequence `after` + 1 into `sink`.
+ *
+ * `after` must be a point where processing state was empty (the watermark saved at a
+ * clean shutdown, or 0). Every tick is replayed, so indicators and open bars come out
+ * as if the engine had never stopped; ticks already committed (looked up through
+ * `lookup`, a connection of its own) are flagged TICK_ALREADY_STORED and only rebuild
+ * that state, so nothing committed before a crash is written or counted twice.
+ */
+bool replay_journal(const std::string& directory, uint64_t after, PersistenceBackend& lookup, TickSink& sink);
+
+#endif // BACKFILL_H
@@ -0,0 +1,69 @@
+// File: /cpp_engine/include/BatchIndicators.h
+
+#ifndef BATCH_INDICATORS_H
+#define BATCH_INDICATORS_H
+
+#include <cstddef>
+#include <vector>
+
+// One symbol's trade history in struct-of-arrays form, ordered by time
+struct TickColumns {
+    std::vector<long long> timestamp_ms;
+    std::vector<long long> trade_id;
+    std::vector<double> close;
+    std::vector<double> volume;
+
+    size_t size() const { return close.size(); }
+    void clear() {
+        timestamp_ms.clear();
+        trade_id.clear();
+        close.clear();
+        volume.clear();
+    }
+};
+
+/**
+ * @brief Whole-series indicator kernels for backfill and recompute.
+ *
+ * Each call turns a column of n inputs into n outputs, with the same seeding and
+ * warm-up (NaN) rules as the streaming indicators. The AVX2 kernels use prefix-scan
+ * formulations: the EMA recurrence is scanned four values at a time so the serial
+ * dependency is one FMA per four ticks, and windowed sums come from prefix sums of
+ * values centred on the first sample (which keeps the subtraction well-conditioned).
+ * Results agree with the streaming path to rounding, not bit for bit.
+ */
+class BatchIndicators {
+public:
+    enum class Kernel { Scalar, AVX2 };
+
+    BatchIndicators();
+
+    Kernel kernel() const { return kernel_; }
+    static const char* kernel_name(Kernel kernel);
+
+    // Forces a kernel (benchmarks, comparisons); ignored if the CPU lacks it
+    void set_kernel(Kernel kernel);
+
+    // Legacy recurrence, seeded with x[0]
+    void ema(const double* x, size_t n, int period, double* out) const;
+
+    // NaN for the first period - 1 outputs
+    void sma(const double* x, size_t n, int period, double* out) const;
+
+    // Windowed mean and population variance; NaN for the first period - 1 outputs
+    void rolling_variance(const double* x, size_t n, int period, double* mean_out, double* variance_out) const;
+
+    // VWAP since the start of each UTC day
+    void session_vwap(const long long* timestamp_ms, const double* price, const double* volume, size_t n,
+                      double* out) const;
+
+private:
+    Kernel kernel_;
+    mutable std::vector<double> prefix_;    // Scratch prefix sums, reused across calls
+    mutable std::vector<double> prefix_sq_;
+
+    // out[i] = initial + sum over j <= i of (x[j] - offset) * (y ? y[j] - offset : 1)
+    void scan(const double* x, const double* y, size_t n, double offset, double initial, double* out) const;
+};
+
+#endif // BATCH_INDICATORS_H
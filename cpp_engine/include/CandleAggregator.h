@@ -0,0 +1,64 @@
+// File: /cpp_engine/include/CandleAggregator.h
+
+#ifndef CANDLE_AGGREGATOR_H
+#define CANDLE_AGGREGATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "Constants.h"
+#include "FlatSymbolMap.h"
+#include "TickerData.h"
+
+// One OHLCV bar of a fixed interval, covering [open_time_ms, open_time_ms + interval_ms)
+struct Candle {
+    SymbolId symbol_id;
+    uint32_t trade_count;
+    long long interval_ms;
+    long long open_time_ms;
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+    double quote_volume;    // Sum of price * quantity; vwap = quote_volume / volume
+};
+
+// The open bars of one symbol, one per interval
+class SymbolBars {
+private:
+    Candle bars_[BAR_INTERVAL_COUNT] = {}; // trade_count == 0 means no bar open yet
+
+public:
+    // Folds one trade into the bars, appending the ones it closes to `closed`.
+    // Returns false, changing nothing, for a trade older than the open bars.
+    bool add(const TickerData& trade, std::vector<Candle>& closed);
+
+    // Appends every open (partial) bar to `out` and starts afresh
+    void flush(std::vector<Candle>& out);
+};
+
+/**
+ * @brief Rolls the trade stream into 1s/1m/5m/1h bars per symbol (BAR_INTERVALS_MS).
+ *
+ * Each symbol keeps one open bar per interval. A bar is closed and emitted as soon as a
+ * trade for that symbol lands in a later bucket, so closing follows event time, not
+ * the wall clock. A trade older than the open bar would reopen a bar that was already
+ * emitted; it is counted in late_trades() and left out of the bars (it is still stored
+ * in raw_ohlcv_data). Owned by the processing thread, not thread-safe.
+ */
+class CandleAggregator {
+private:
+    FlatSymbolMap<SymbolBars> open_bars_;
+    size_t late_trades_ = 0;
+
+public:
+    // Folds one trade into its bars; bars it closes are appended to `closed`
+    void add(const TickerData& trade, std::vector<Candle>& closed);
+
+    // Appends every open (partial) bar to `out` and starts afresh, e.g. on shutdown
+    void flush(std::vector<Candle>& out);
+
+    size_t late_trades() const { return late_trades_; }
+};
+
+#endif // CANDLE_AGGREGATOR_H
@@ -0,0 +1,164 @@
+// File: /cpp_engine/include/ColumnarTickStore.h
+
+#ifndef COLUMNAR_TICK_STORE_H
+#define COLUMNAR_TICK_STORE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Constants.h"
+#include "FlatSymbolMap.h"
+#include "Persistence.h"
+
+// --- On-disk format ---
+
+constexpr char TICK_SEGMENT_MAGIC[8] = {'T', 'K', 'S', 'E', 'G', '0', '0', '1'};
+constexpr size_t TICK_BLOCK_ROWS = 4096;                              // Rows per block
+constexpr size_t TICK_BLOCK_BYTES = TICK_BLOCK_ROWS * 4 * sizeof(double); // Four 8-byte columns
+constexpr size_t TICK_SEGMENT_DATA_OFFSET = 4096;                     // Blocks start page-aligned
+
+// Start of every segment file; the rest of the first page is unused
+struct TickSegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t block_rows;
+    long long day_start_ms;     // UTC midnight of the day the segment covers
+    uint64_t row_count;         // Committed rows; anything after them is ignored
+    uint64_t footer_offset;     // Block index position once sealed, 0 while appending
+    uint8_t reserved[24];
+};
+static_assert(sizeof(TickSegmentHeader) == 64, "TickSegmentHeader must stay 64 bytes");
+
+// One footer entry per block of a sealed segment
+struct TickBlockIndex {
+    long long min_timestamp_ms;
+    long long max_timestamp_ms;
+    uint64_t rows;
+};
+
+// --- Compressed (cold) segments, ".segz" ---
+
+constexpr char TICK_SEGMENT_COMPRESSED_MAGIC[8] = {'T', 'K', 'S', 'E', 'G', 'Z', '0', '1'};
+
+// Same header as a plain segment (footer_offset points at the block index); the encoded
+// columns follow it back to back
+struct TickCompressedBlockIndex {
+    long long min_timestamp_ms;
+    long long max_timestamp_ms;
+    uint64_t rows;
+    uint64_t column_offset[4];  // File offset of each encoded column (see TickCodec.h)
+    uint64_t end_offset;
+};
+static_assert(sizeof(TickCompressedBlockIndex) == 64, "TickCompressedBlockIndex must stay 64 bytes");
+
+struct TickCompressionStats {
+    size_t segments = 0;
+    size_t blocks = 0;
+    uint64_t rows = 0;
+    uint64_t raw_bytes = 0;             // Column bytes before compression
+    uint64_t column_bytes[4] = {};      // Encoded bytes per column
+    size_t fixed_point_blocks = 0;      // Price and quantity column blocks stored as fixed point (the rest use XOR)
+};
+
+/**
+ * @brief Rewrites every sealed segment under `directory` whose day ended by `before_ms`
+ * as a compressed ".segz" file: delta-of-delta for timestamps and trade ids; prices and
+ * quantities as fixed point (up to TICK_MAX_DECIMALS) where that is exact for the whole
+ * block, Gorilla XOR otherwise or if `fixed_point` is false.
+ * scan() decodes them a block at a time. Run it with the engine stopped.
+ */
+bool compress_tick_segments(const std::string& directory, long long before_ms, bool fixed_point,
+                            TickCompressionStats& stats);
+
+// Columns a scan asks for (bit mask)
+enum TickColumn : unsigned {
+    TICK_COLUMN_TIMESTAMP = 1u << 0,
+    TICK_COLUMN_TRADE_ID = 1u << 1,
+    TICK_COLUMN_PRICE = 1u << 2,
+    TICK_COLUMN_QTY = 1u << 3,
+    TICK_COLUMN_ALL = 0xFu
+};
+
+// One block of a scan; columns that were not requested are nullptr
+struct TickBlockView {
+    const long long* timestamp_ms;
+    const long long* trade_id;
+    const double* price;
+    const double* qty;
+    size_t rows;
+};
+
+/**
+ * @brief Storage backend that keeps raw trades in columnar segment files instead of
+ * raw_ohlcv_data; metrics, bars, indicator values and transactions go to `db`.
+ *
+ * Each symbol gets one segment file per UTC day ("BTCUSDT/2024-01-31.seg" under the
+ * store directory). A segment is a sequence of TICK_BLOCK_ROWS-row blocks, each holding
+ * the timestamp, trade id, price and quantity columns as contiguous arrays, appended
+ * through a memory mapping that grows in whole blocks. Rows become visible when the
+ * header's row count is bumped at commit; rollback just forgets the rows written since.
+ * A segment is sealed, with a footer holding each block's timestamp range, once its
+ * symbol moves on to a later day and on close(). Pages are forced to disk every
+ * TICK_STORE_SYNC_INTERVAL_MS and when sealing, so like synchronous=NORMAL an OS crash
+ * can lose the last interval (the tick journal covers it). Trades are appended as they
+ * come, without raw_ohlcv_data's (trade_id, symbol) duplicate check. Used by the writer
+ * thread only; scan() opens files read-only and may run anywhere.
+ */
+class ColumnarTickStore : public PersistenceBackend {
+public:
+    explicit ColumnarTickStore(PersistenceBackend& db, const std::string& directory = TICK_STORE_DIR);
+    ~ColumnarTickStore() override;
+
+    ColumnarTickStore(const ColumnarTickStore&) = delete;
+    ColumnarTickStore& operator=(const ColumnarTickStore&) = delete;
+
+    // Creates the store directory
+    bool open();
+
+    // Seals every open segment
+    void close();
+
+    bool insert_raw_batch(const std::vector<TickerData>& rows) override;
+    bool insert_metrics_batch(const std::vector<MetricRow>& rows, bool replace = false) override;
+    bool insert_bars_batch(const std::vector<Candle>& bars) override;
+    bool insert_indicator_batch(const std::vector<IndicatorValue>& values) override;
+
+    bool load_ticks(const std::string& symbol, TickColumns& out) override;
+    bool mark_stored(std::vector<TickerData>& ticks, size_t& stored) override;
+
+    bool begin_transaction() override;
+    bool commit_transaction() override;
+    bool rollback_transaction() override;
+
+    /**
+     * @brief Calls `fn` for every committed block of `symbol` that may hold trades in
+     * [from_ms, to_ms], in day order. Blocks are filtered by the footer index (or the
+     * timestamps themselves for unsealed segments), not rows: callers filter rows.
+     * Only the `columns` bits are filled. Views point straight into the mapping of a plain
+     * segment; blocks of a compressed segment are decoded, requested columns only, into
+     * scratch buffers that the next block overwrites.
+     */
+    bool scan(const std::string& symbol, long long from_ms, long long to_ms, unsigned columns,
+              const std::function<void(const TickBlockView&)>& fn) const;
+
+    const std::string& directory() const { return directory_; }
+
+private:
+    struct Segment;
+
+    PersistenceBackend& db_;
+    std::string directory_;
+    FlatSymbolMap<std::vector<std::unique_ptr<Segment>>> segments_; // Open segments per symbol
+    std::vector<Segment*> touched_;                                 // Appended to in this transaction
+    std::chrono::steady_clock::time_point last_sync_;
+
+    Segment* segment_for(const TickerData& tick);
+    void seal_stale_segments(SymbolId symbol);
+    void sync_all();
+};
+
+#endif // COLUMNAR_TICK_STORE_H
@@ -2,6 +2,7 @@
 #define CONSTANTS_H
 
 #include <string>
+#include <cstddef>
 
 // --- Socket Communication Parameters ---
 const std::string SERVER_IP = "127.0.0.1"; // Localhost IP
@@ -11,5 +12,51 @@ const int SERVER_PORT = 12345;           // Port for Python client to connect to
 const int MAX_CLIENTS = 5;     
 const int BATCH_SIZE = 100;    
 const int TIMEOUT_MS = 5000;     
+const int FLUSH_TIMEOUT_MS = 500;  // Max time a partial batch waits before being flushed
+const size_t MAX_IN_FLIGHT_BATCHES = 8; // Computed batches queued for the DB writer before backpressure
+const size_t QUEUE_CAPACITY = 1 << 16; // Ingest -> processing ring slots, split across shards (rounded up to a power of two)
+
+// --- Processing Shards (override with --shards) ---
+const int PROCESSING_SHARDS = 4;                // ProcessingThreads, each owning the symbols that hash to it
+const size_t MIN_SHARD_QUEUE_CAPACITY = 1 << 12; // Lower bound for one shard's ring
+
+// --- Work-Stealing Processing (default; --scheduler sharded selects the shards above) ---
+const int PROCESSING_WORKERS = 4;          // Worker threads running per-symbol actors (override with --workers)
+const int EXECUTOR_STATS_INTERVAL_MS = 10000; // How often per-worker utilization is logged
+
+// --- Tick Journal (disable with --no-journal) ---
+const std::string JOURNAL_DIR = "../db_setup/journal"; // Segment files of the write-ahead tick journal
+const size_t JOURNAL_SEGMENT_RECORDS = 1 << 20;    // Records per segment file (80 MB)
+const int JOURNAL_SYNC_INTERVAL_MS = 100;          // Max window of journaled ticks a crash can lose
+const size_t JOURNAL_RETAIN_SEGMENTS = 4;          // Committed segments kept for offline replay
+const size_t JOURNAL_REPLAY_BATCH = 4096;          // Ticks per batch handed to the pipeline on replay
+
+// --- Columnar Tick Store (--tick-store columnar) ---
+const std::string TICK_STORE_DIR = "../db_setup/ticks"; // Per-symbol, per-day segment files of raw trades
+const int TICK_STORE_SYNC_INTERVAL_MS = 1000;      // How often appended segment pages are forced to disk
+const int TICK_MAX_DECIMALS = 8;                   // --compress-ticks stores prices/quantities as fixed point up to this precision
+
+// --- Partitioned Database (--partition-hours N) ---
+const std::string DB_PARTITION_DIR = "../db_setup/partitions"; // One SQLite file per interval, e.g. crypto_data_2024-01-31.db
+const size_t DB_PARTITIONS_OPEN = 2;               // Newest partitions kept open for late trades
+
+// --- Retention Compaction (--keep-ticks-days / --keep-metrics-days) ---
+const long long RETENTION_BAR_INTERVAL_MS = 60000;      // Expired trades are rolled into bars of this interval (one of BAR_INTERVALS_MS)
+const long long RETENTION_METRIC_RESOLUTION_MS = 60000; // One metrics row per symbol and bucket is kept (override with --metrics-resolution)
+const size_t RETENTION_CHUNK_ROWS = 5000;          // Rows deleted per transaction
+const int RETENTION_CHUNK_PAUSE_MS = 50;           // Pause between chunks, leaving the write lock to the writer
+const int RETENTION_INTERVAL_MS = 10 * 60 * 1000;  // Time between compaction passes
+
+// --- Event-Loop Ingestion (Linux epoll) ---
+const int IO_THREADS = 2;          // Fixed number of I/O threads multiplexing all client sockets
+const int EPOLL_MAX_EVENTS = 64;   // Events fetched per epoll_wait call
+
+// --- Indicators (see IndicatorRegistry for the spec syntax; override with --indicators) ---
+// aggregated_metrics stores "vwap", "sma_20", "ema_20" and "ema_50"; other outputs go to indicator_values
+const std::string DEFAULT_INDICATORS = "vwap,sma:20,ema:20:50";
+
+// --- Candle Aggregation ---
+const size_t BAR_INTERVAL_COUNT = 4;
+const long long BAR_INTERVALS_MS[BAR_INTERVAL_COUNT] = {1000, 60000, 300000, 3600000}; // 1s, 1m, 5m, 1h
 
 #endif 
\ No newline at end of file
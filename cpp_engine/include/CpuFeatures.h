@@ -0,0 +1,51 @@
+// File: /cpp_engine/include/CpuFeatures.h
+
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define ENGINE_X86 1
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #endif
+#endif
+
+// GCC/Clang need per-function target attributes to emit AVX2 in a baseline build; MSVC does not
+#if defined(ENGINE_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define ENGINE_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define ENGINE_TARGET(isa)
+#endif
+
+/**
+ * @brief Instruction sets detected once at startup, used to pick SIMD kernels at runtime.
+ */
+struct CpuFeatures {
+    bool sse2 = false;
+    bool sse42 = false;
+    bool avx2 = false;
+};
+
+inline const CpuFeatures& cpu_features() {
+    static const CpuFeatures features = [] {
+        CpuFeatures f;
+    #if defined(ENGINE_X86) && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        f.sse2 = __builtin_cpu_supports("sse2");
+        f.sse42 = __builtin_cpu_supports("sse4.2");
+        f.avx2 = __builtin_cpu_supports("avx2");
+    #elif defined(ENGINE_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        f.sse2 = (info[3] & (1 << 26)) != 0;
+        f.sse42 = (info[2] & (1 << 20)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        __cpuidex(info, 7, 0);
+        f.avx2 = osxsave && (info[1] & (1 << 5)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    #endif
+        return f;
+    }();
+    return features;
+}
+
+#endif // CPU_FEATURES_H
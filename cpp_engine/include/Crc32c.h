@@ -0,0 +1,15 @@
+// File: /cpp_engine/include/Crc32c.h
+
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief CRC-32C (Castagnoli) of `length` bytes, continuing from `crc` (0 to start).
+ * Uses the SSE4.2 crc32 instruction when the CPU has it, a lookup table otherwise.
+ */
+uint32_t crc32c(const void* data, size_t length, uint32_t crc = 0);
+
+#endif // CRC32C_H
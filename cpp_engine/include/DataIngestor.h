@@ -5,26 +5,85 @@
 
 #include <thread>
 #include <vector>
+#include <memory>
+#include <atomic>
 #include <iostream>
 #include <functional>
-#include "SafeQueue.h"
+#include <string_view>
+#include "TickSink.h"
+#include "LineBuffer.h"
+#include "TickDecoder.h"
+#include "WireProtocol.h"
 #include "Constants.h"
 
+/**
+ * @brief How accepted client sockets are serviced.
+ * ThreadPerClient: one blocking std::thread per connection (portable).
+ * EventLoop: IO_THREADS workers multiplex all sockets with edge-triggered epoll (Linux only).
+ */
+enum class IngestMode {
+    ThreadPerClient,
+    EventLoop
+};
+
+#ifdef __linux__
+const IngestMode DEFAULT_INGEST_MODE = IngestMode::EventLoop;
+#else
+const IngestMode DEFAULT_INGEST_MODE = IngestMode::ThreadPerClient;
+#endif
+
 /**
  * @brief Manages the TCP/IP server responsible for receiving data from Python clients.
  */
 class DataIngestor {
 private:
-    SafeQueue<TickerData>& data_queue_;
+    TickSink& sink_;
+    IngestMode mode_;
     std::vector<std::thread> client_threads_;
-    bool running_ = true;
+    std::atomic<bool> running_{false};
     int server_socket_;
 
     // Handle data reception from a single client
     void handle_client(int client_socket);
 
+    // Receive state of one client socket
+    struct ClientConnection {
+        LineBuffer buffer;
+        WireFormat format = WireFormat::Unknown;
+        BinaryFrameDecoder binary;
+    };
+
+    // Decode state owned by one receiving thread (client thread or I/O worker)
+    struct DecodeContext {
+        TickDecoder decoder;
+        std::vector<TickerData> batch;
+    };
+
+    // Negotiates the wire format, decodes everything buffered and hands it to the processing stage.
+    // Returns false on a protocol error (the connection must be closed).
+    bool process_buffer(ClientConnection& conn, DecodeContext& ctx);
+
+    // CSV path: decodes every complete line buffered for a connection
+    void drain_lines(LineBuffer& buffer, DecodeContext& ctx);
+
+#ifdef __linux__
+    // One epoll instance + thread; owns every connection registered on it
+    struct IoWorker {
+        int epoll_fd = -1;
+        int wake_fd = -1;   // eventfd used to interrupt epoll_wait on shutdown
+        std::thread thread;
+    };
+    std::vector<std::unique_ptr<IoWorker>> io_workers_;
+    size_t next_worker_ = 0;
+
+    bool start_io_workers();
+    void stop_io_workers();
+    void io_loop(IoWorker& worker);
+    bool dispatch_to_worker(int client_socket);
+#endif
+
 public:
-    DataIngestor(SafeQueue<TickerData>& queue);
+    DataIngestor(TickSink& sink, IngestMode mode = DEFAULT_INGEST_MODE);
     ~DataIngestor();
 
     // Starts the main server thread
@@ -34,4 +93,4 @@ public:
     void stop_server();
 };
 
-#endif // DATA_INGESTOR_H
\ No newline at end of file
+#endif // DATA_INGESTOR_H
@@ -0,0 +1,96 @@
+// File: /cpp_engine/include/FlatSymbolMap.h
+
+#ifndef FLAT_SYMBOL_MAP_H
+#define FLAT_SYMBOL_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "SymbolTable.h"
+
+/**
+ * @brief Open-addressing hash map from SymbolId to a per-symbol state struct.
+ *
+ * Keys and values live in two contiguous arrays (linear probing, power-of-two capacity,
+ * load factor <= 1/2), so a lookup is a multiply, a shift and usually one cache line.
+ * Entries are never erased; the table only grows. Not thread-safe: each map is owned by
+ * the thread that processes its symbols.
+ */
+template <typename V>
+class FlatSymbolMap {
+private:
+    std::vector<SymbolId> keys_;
+    std::vector<V> values_;
+    size_t size_ = 0;
+    unsigned shift_;
+
+    size_t slot_for(SymbolId id) const {
+        // Fibonacci hashing spreads dense ids across the table
+        return static_cast<size_t>((static_cast<uint64_t>(id) * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<SymbolId> old_keys = std::exchange(keys_, std::vector<SymbolId>(capacity, INVALID_SYMBOL));
+        std::vector<V> old_values = std::exchange(values_, std::vector<V>(capacity));
+        shift_ = 64;
+        for (size_t c = capacity; c > 1; c >>= 1) --shift_;
+
+        for (size_t i = 0; i < old_keys.size(); ++i) {
+            if (old_keys[i] == INVALID_SYMBOL) continue;
+            size_t slot = slot_for(old_keys[i]);
+            while (keys_[slot] != INVALID_SYMBOL) slot = (slot + 1) & (capacity - 1);
+            keys_[slot] = old_keys[i];
+            values_[slot] = std::move(old_values[i]);
+        }
+    }
+
+public:
+    explicit FlatSymbolMap(size_t initial_capacity = 64) {
+        size_t capacity = 2;
+        while (capacity < initial_capacity) capacity <<= 1;
+        keys_.assign(capacity, INVALID_SYMBOL);
+        values_.resize(capacity);
+        shift_ = 64;
+        for (size_t c = capacity; c > 1; c >>= 1) --shift_;
+    }
+
+    // Returns the state for `id` (never INVALID_SYMBOL), value-initializing it on first access
+    V& operator[](SymbolId id) {
+        size_t mask = keys_.size() - 1;
+        for (size_t slot = slot_for(id);; slot = (slot + 1) & mask) {
+            if (keys_[slot] == id) return values_[slot];
+            if (keys_[slot] == INVALID_SYMBOL) {
+                if ((size_ + 1) * 2 > keys_.size()) {
+                    rehash(keys_.size() * 2);
+                    return (*this)[id];
+                }
+                keys_[slot] = id;
+                values_[slot] = V();
+                ++size_;
+                return values_[slot];
+            }
+        }
+    }
+
+    // Returns nullptr if `id` has no state yet
+    V* find(SymbolId id) {
+        size_t mask = keys_.size() - 1;
+        for (size_t slot = slot_for(id);; slot = (slot + 1) & mask) {
+            if (keys_[slot] == id) return &values_[slot];
+            if (keys_[slot] == INVALID_SYMBOL) return nullptr;
+        }
+    }
+
+    size_t size() const { return size_; }
+
+    // Visits every (id, state) pair in table order
+    template <typename Fn>
+    void for_each(Fn&& fn) {
+        for (size_t i = 0; i < keys_.size(); ++i) {
+            if (keys_[i] != INVALID_SYMBOL) fn(keys_[i], values_[i]);
+        }
+    }
+};
+
+#endif // FLAT_SYMBOL_MAP_H
@@ -0,0 +1,313 @@
+// File: /cpp_engine/include/Indicators.h
+
+#ifndef INDICATORS_H
+#define INDICATORS_H
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "TickerData.h"
+
+// Value reported by an indicator that has not seen enough ticks yet (stored as NULL)
+constexpr double INDICATOR_WARMING_UP = std::numeric_limits<double>::quiet_NaN();
+
+/**
+ * @brief Streaming indicator over one symbol's trades. update() is O(1) (amortized
+ * for the time-windowed VWAP) and never allocates once the indicator is warmed up
+ * (the VWAP's ring only grows when a window holds more trades than any before).
+ */
+class Indicator {
+public:
+    virtual ~Indicator() = default;
+    virtual void update(const TickerData& tick) = 0;
+    virtual size_t output_count() const { return 1; }
+    virtual double value(size_t output = 0) const = 0;
+
+    // Pipeline entry point: update, then write all output_count() values to `outputs`.
+    // Overridden by fused indicators so a tick costs one virtual call per indicator.
+    virtual void update_outputs(const TickerData& tick, double* outputs) {
+        update(tick);
+        for (size_t i = 0; i < output_count(); ++i) outputs[i] = value(i);
+    }
+};
+
+// --- Building blocks ---
+
+// Fixed-length window of the most recent values
+class RingWindow {
+private:
+    std::vector<double> values_;
+    size_t next_ = 0;
+    size_t size_ = 0;
+
+public:
+    explicit RingWindow(size_t length) : values_(length > 0 ? length : 1) {}
+
+    size_t capacity() const { return values_.size(); }
+    size_t size() const { return size_; }
+    bool full() const { return size_ == values_.size(); }
+    double oldest() const { return values_[next_]; } // Only meaningful when full()
+
+    // Stores `value`, overwriting the oldest one once full
+    void push(double value) {
+        values_[next_] = value;
+        next_ = next_ + 1 == values_.size() ? 0 : next_ + 1;
+        if (size_ < values_.size()) ++size_;
+    }
+
+    // True right after the write position wrapped to the start of the buffer
+    bool wrapped() const { return next_ == 0; }
+
+    double sum() const {
+        double total = 0.0;
+        for (size_t i = 0; i < size_; ++i) total += values_[i];
+        return total;
+    }
+};
+
+// Legacy EMA recurrence: seeded with the first price, then price * k + ema * (1 - k)
+class Ema : public Indicator {
+private:
+    double multiplier_;
+    double ema_ = 0.0;
+    bool seeded_ = false;
+
+public:
+    explicit Ema(int period) : multiplier_(2.0 / (static_cast<double>(period) + 1.0)) {}
+
+    void add(double price) {
+        ema_ = seeded_ ? (price * multiplier_) + (ema_ * (1.0 - multiplier_)) : price;
+        seeded_ = true;
+    }
+    bool seeded() const { return seeded_; }
+    double current() const { return ema_; }
+
+    void update(const TickerData& tick) override { add(tick.close); }
+    double value(size_t) const override { return seeded_ ? ema_ : INDICATOR_WARMING_UP; }
+};
+
+/**
+ * @brief Fused EMAs for a compile-time set of periods, e.g. EmaBank<20, 50>.
+ *
+ * The multipliers are constexpr and the states sit in one array, so a tick updates
+ * every EMA in a single unrolled pass with no per-period branching. The recurrence is
+ * the legacy one, so values are bit-identical to per-period Ema instances.
+ */
+template <int... Periods>
+class EmaBank : public Indicator {
+public:
+    static constexpr size_t COUNT = sizeof...(Periods);
+    static_assert(COUNT > 0, "EmaBank needs at least one period");
+    static_assert(((Periods > 0) && ...), "EMA periods must be positive");
+
+    static constexpr int periods[COUNT] = {Periods...};
+    static constexpr double multipliers[COUNT] = {(2.0 / (static_cast<double>(Periods) + 1.0))...};
+    static constexpr double retention[COUNT] = {(1.0 - 2.0 / (static_cast<double>(Periods) + 1.0))...};
+
+    void add(double price) {
+        if (!seeded_) {
+            for (size_t i = 0; i < COUNT; ++i) ema_[i] = price;
+            seeded_ = true;
+            return;
+        }
+        for (size_t i = 0; i < COUNT; ++i) {
+            ema_[i] = (price * multipliers[i]) + (ema_[i] * retention[i]);
+        }
+    }
+    double current(size_t i) const { return ema_[i]; }
+
+    void update(const TickerData& tick) override { add(tick.close); }
+    void update_outputs(const TickerData& tick, double* outputs) override {
+        add(tick.close);
+        for (size_t i = 0; i < COUNT; ++i) outputs[i] = ema_[i];
+    }
+    size_t output_count() const override { return COUNT; }
+    double value(size_t output) const override { return seeded_ ? ema_[output] : INDICATOR_WARMING_UP; }
+
+private:
+    double ema_[COUNT] = {};
+    bool seeded_ = false;
+};
+
+// Same fused update for period sets only known at runtime (no preset EmaBank matches)
+class RuntimeEmaBank : public Indicator {
+private:
+    std::vector<double> multipliers_;
+    std::vector<double> retention_;
+    std::vector<double> ema_;
+    bool seeded_ = false;
+
+public:
+    explicit RuntimeEmaBank(const std::vector<int>& periods);
+    void update(const TickerData& tick) override;
+    size_t output_count() const override { return ema_.size(); }
+    double value(size_t output) const override { return seeded_ ? ema_[output] : INDICATOR_WARMING_UP; }
+};
+
+// Returns a preset EmaBank specialization for `periods` if one exists, else a RuntimeEmaBank
+std::unique_ptr<Indicator> make_ema_bank(const std::vector<int>& periods);
+
+// --- Indicators ---
+
+// Volume-weighted average price since the start of the current UTC day
+class SessionVwap : public Indicator {
+private:
+    long long session_start_ms_ = -1;
+    double price_volume_ = 0.0;
+    double volume_ = 0.0;
+
+public:
+    void update(const TickerData& tick) override;
+    double value(size_t) const override;
+};
+
+// Volume-weighted average price over the trades of the last `window_ms`
+class RollingVwap : public Indicator {
+private:
+    struct Entry { long long timestamp_ms; double price_volume; double volume; };
+    long long window_ms_;
+    // Ring of the trades in the window, oldest at head_; doubled when full
+    std::vector<Entry> entries_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    double price_volume_ = 0.0;
+    double volume_ = 0.0;
+
+public:
+    explicit RollingVwap(long long window_ms) : window_ms_(window_ms) {}
+    void update(const TickerData& tick) override;
+    double value(size_t) const override;
+};
+
+// Simple moving average of closes with a running sum (re-summed once per wrap to bound drift)
+class Sma : public Indicator {
+private:
+    RingWindow window_;
+    double sum_ = 0.0;
+
+public:
+    explicit Sma(int period) : window_(period) {}
+    void update(const TickerData& tick) override;
+    double value(size_t) const override;
+};
+
+// Wilder's RSI on trade-to-trade price changes
+class Rsi : public Indicator {
+private:
+    int period_;
+    int changes_ = 0;
+    double last_price_ = 0.0;
+    bool has_price_ = false;
+    double avg_gain_ = 0.0;
+    double avg_loss_ = 0.0;
+
+public:
+    explicit Rsi(int period) : period_(period) {}
+    void update(const TickerData& tick) override;
+    double value(size_t) const override;
+};
+
+// MACD line, signal line and histogram
+class Macd : public Indicator {
+private:
+    Ema fast_;
+    Ema slow_;
+    Ema signal_;
+
+public:
+    Macd(int fast, int slow, int signal) : fast_(fast), slow_(slow), signal_(signal) {}
+    void update(const TickerData& tick) override;
+    size_t output_count() const override { return 3; }
+    double value(size_t output) const override;
+};
+
+// Bollinger bands (middle, upper, lower); windowed Welford mean/variance
+class Bollinger : public Indicator {
+private:
+    RingWindow window_;
+    double width_;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+
+public:
+    Bollinger(int period, double width) : window_(period), width_(width) {}
+    void update(const TickerData& tick) override;
+    size_t output_count() const override { return 3; }
+    double value(size_t output) const override;
+};
+
+// Wilder's average true range; on the trade stream the true range is |price change|
+class Atr : public Indicator {
+private:
+    int period_;
+    int ranges_ = 0;
+    double last_close_ = 0.0;
+    bool has_close_ = false;
+    double atr_ = 0.0;
+
+public:
+    explicit Atr(int period) : period_(period) {}
+    void update(const TickerData& tick) override;
+    double value(size_t) const override;
+};
+
+// --- Registry ---
+
+// Indicator instances for one symbol, in the order of IndicatorRegistry::output_names()
+using IndicatorSet = std::vector<std::unique_ptr<Indicator>>;
+
+/**
+ * @brief Maps indicator kinds to factories and holds the set configured at startup.
+ *
+ * A spec is a comma-separated list of `kind[:param[:param...]]`, e.g.
+ * "vwap,vwap:300,sma:20,ema:20:50,rsi:14,macd:12:26:9,bb:20:2,atr:14".
+ * Each output is named after its kind and parameters ("ema_20", "bb_upper_20_2"),
+ * and every symbol gets its own instances from create_set(). New kinds can be added
+ * with register_kind() before configure().
+ */
+class IndicatorRegistry {
+public:
+    using Factory = std::function<std::unique_ptr<Indicator>(const std::vector<double>& params)>;
+
+    struct Kind {
+        size_t min_params;
+        size_t max_params;
+        std::vector<double> defaults;       // Used for omitted trailing parameters
+        std::vector<std::string> outputs;   // Output name prefixes, e.g. {"macd", "macd_signal", "macd_hist"}
+        Factory make;
+        bool output_per_param = false;      // One output per parameter ("ema:20:50" -> ema_20, ema_50)
+    };
+
+    IndicatorRegistry(); // Registers the built-in kinds
+
+    void register_kind(const std::string& name, Kind kind);
+
+    // Replaces the configured set; on a malformed spec returns false and sets `error`
+    bool configure(std::string_view spec, std::string& error);
+
+    const std::vector<std::string>& output_names() const { return output_names_; }
+
+    // Index into output_names(), or npos if the output is not configured
+    size_t output_index(std::string_view name) const;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    IndicatorSet create_set() const;
+
+private:
+    struct Configured {
+        size_t kind;                        // Index into kinds_
+        std::vector<double> params;
+    };
+
+    std::vector<std::pair<std::string, Kind>> kinds_;
+    std::vector<Configured> configured_;
+    std::vector<std::string> output_names_;
+
+    size_t find_kind(std::string_view name) const;
+};
+
+#endif // INDICATORS_H
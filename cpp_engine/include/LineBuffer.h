@@ -0,0 +1,100 @@
+// File: /cpp_engine/include/LineBuffer.h
+
+#ifndef LINE_BUFFER_H
+#define LINE_BUFFER_H
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+/**
+ * @brief Per-connection reassembly buffer for newline-framed records.
+ *
+ * recv() writes straight into the free tail of the buffer. Complete lines are exposed
+ * in place (complete_lines() for batch decoding, drain_lines() for per-line callbacks)
+ * and consume() moves the trailing partial line to the front, so a record split across
+ * two reads is joined on the next one. The storage is allocated once per connection;
+ * framing itself never touches the heap.
+ */
+class LineBuffer {
+private:
+    std::unique_ptr<char[]> data_;
+    size_t capacity_;
+    size_t size_ = 0;
+    size_t dropped_lines_ = 0;
+
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 32 * 1024;
+
+    explicit LineBuffer(size_t capacity = DEFAULT_CAPACITY)
+        : data_(new char[capacity]), capacity_(capacity) {}
+
+    // Destination for the next recv() and how many bytes it may write
+    char* write_ptr() { return data_.get() + size_; }
+    size_t writable() const { return capacity_ - size_; }
+
+    // Marks `bytes` written at write_ptr() as valid data
+    void commit(size_t bytes) { size_ += bytes; }
+
+    size_t buffered() const { return size_; }
+    std::string_view buffered_data() const { return std::string_view(data_.get(), size_); }
+    size_t dropped_lines() const { return dropped_lines_; }
+
+    /**
+     * @brief View over every complete line currently buffered, i.e. up to and including
+     * the last '\n'. Empty if no line is complete yet.
+     */
+    std::string_view complete_lines() const {
+        const char* begin = data_.get();
+        for (size_t i = size_; i > 0; --i) {
+            if (begin[i - 1] == '\n') return std::string_view(begin, i);
+        }
+        return std::string_view();
+    }
+
+    /**
+     * @brief Releases the first `bytes` (a complete_lines() prefix) and moves the partial
+     * line that follows to the front. If the buffer is full and still holds no newline,
+     * the oversized record is discarded so the stream can resync.
+     */
+    void consume(size_t bytes) {
+        size_t remainder = size_ - bytes;
+        if (remainder == capacity_) {
+            ++dropped_lines_;
+            remainder = 0;
+        } else if (remainder > 0 && bytes > 0) {
+            std::memmove(data_.get(), data_.get() + bytes, remainder);
+        }
+        size_ = remainder;
+    }
+
+    /**
+     * @brief Invokes on_line(std::string_view) for every complete line, without the
+     * terminating '\n' (and '\r', if present), then consumes them. Empty lines are skipped.
+     * The views are only valid during the callback.
+     * @return Number of lines delivered.
+     */
+    template <typename LineHandler>
+    size_t drain_lines(LineHandler&& on_line) {
+        std::string_view lines = complete_lines();
+        size_t delivered = 0;
+        size_t line_start = 0;
+
+        while (line_start < lines.size()) {
+            size_t nl = lines.find('\n', line_start);
+            size_t line_end = nl;
+            if (line_end > line_start && lines[line_end - 1] == '\r') --line_end;
+            if (line_end > line_start) {
+                on_line(lines.substr(line_start, line_end - line_start));
+                ++delivered;
+            }
+            line_start = nl + 1;
+        }
+
+        consume(lines.size());
+        return delivered;
+    }
+};
+
+#endif // LINE_BUFFER_H
@@ -0,0 +1,56 @@
+// File: /cpp_engine/include/MappedFile.h
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief A whole file mapped into memory (mmap on POSIX, a file mapping on Windows).
+ *
+ * ReadWrite creates the file if needed and grows it to the requested size first, so
+ * writers can fill the mapping without extending the file on every append. sync()
+ * forces a byte range, plus the file's data, to disk. Not thread-safe; the owner
+ * serializes access or hands out read-only views.
+ */
+class MappedFile {
+public:
+    enum class Mode { ReadOnly, ReadWrite };
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // ReadWrite: `size` is the minimum file size (0 keeps the current size).
+    // ReadOnly: maps the whole file and ignores `size`. Returns false on any OS error.
+    bool open(const std::string& path, Mode mode, size_t size = 0);
+    void close();
+
+    bool is_open() const { return opened_; }
+    char* data() { return data_; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    const std::string& path() const { return path_; }
+
+    // Writes [offset, offset + length) back to the file and waits for it to reach the disk
+    bool sync(size_t offset, size_t length);
+
+private:
+    std::string path_;
+    char* data_ = nullptr;
+    size_t size_ = 0;
+    bool opened_ = false;
+    bool writable_ = false;
+
+#ifdef _WIN32
+    void* file_ = nullptr;      // HANDLE
+    void* mapping_ = nullptr;   // HANDLE
+#else
+    int fd_ = -1;
+#endif
+};
+
+#endif // MAPPED_FILE_H
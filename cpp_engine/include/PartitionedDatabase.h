@@ -0,0 +1,134 @@
+// File: /cpp_engine/include/PartitionedDatabase.h
+
+#ifndef PARTITIONED_DATABASE_H
+#define PARTITIONED_DATABASE_H
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Constants.h"
+#include "Persistence.h"
+
+// Tables split by time; journal_state and any other table stay in the catalog database
+const std::vector<std::string> PARTITIONED_TABLES = {"raw_ohlcv_data", "aggregated_metrics", "ohlcv_bars",
+                                                     "indicator_values"};
+
+// One partition file and the start of the interval it covers
+struct DbPartition {
+    long long start_ms;
+    std::string path;
+};
+
+/**
+ * @brief Storage backend that writes every row into the SQLite file of its time interval
+ * ("crypto_data_2024-01-31.db", or "..._2024-01-31T06.db" for sub-day intervals, under
+ * the partition directory), keyed by the trade time (bars: their open time).
+ *
+ * The catalog database (DB_FILE) keeps the schema new partitions are created from and
+ * everything that is not time-keyed, such as journal_state. Partitions are opened on
+ * demand by the writer thread, but a background thread opens the next interval's file
+ * (schema, pragmas, prepared statements) as soon as the writer starts on the newest one,
+ * and closes partitions the writer has moved away from (the final WAL checkpoint), so
+ * rolling over at the boundary costs the writer a map lookup. The DB_PARTITIONS_OPEN
+ * newest partitions stay open for late trades; older ones reopen on demand.
+ *
+ * A group commit is one SQLite transaction per partition it touches, committed oldest
+ * first: a crash between two of them (only possible at a boundary) can leave a bar that
+ * closed across the boundary missing or, after journal replay, counted twice.
+ *
+ * Reads go through a connection to the catalog with the partitions of a time range
+ * ATTACHed and shadowed by UNION ALL views (open_reader()); load_ticks() and
+ * mark_stored() work that way, a window of max_attached() partitions at a time. Keep
+ * one interval per directory: partitions are found by their file names. Partitions hold
+ * symbol ids only; the symbols table is the catalog's.
+ */
+class PartitionedDatabase : public PersistenceBackend {
+public:
+    PartitionedDatabase(PersistenceManager& catalog, long long interval_ms, const std::string& directory = DB_PARTITION_DIR);
+    ~PartitionedDatabase() override;
+
+    PartitionedDatabase(const PartitionedDatabase&) = delete;
+    PartitionedDatabase& operator=(const PartitionedDatabase&) = delete;
+
+    // Writing only: reads the partition schema from the catalog, creates the directory and
+    // starts the background opener; `config` applies to every partition connection
+    bool open(const DbConfig& config = DbConfig());
+
+    // Closes every partition and stops the background opener
+    void close();
+
+    // Brings partition files written with an older schema up to SCHEMA_VERSION (open() does this)
+    bool migrate_partitions();
+
+    bool insert_raw_batch(const std::vector<TickerData>& rows) override;
+    bool insert_metrics_batch(const std::vector<MetricRow>& rows, bool replace = false) override;
+    bool insert_bars_batch(const std::vector<Candle>& bars) override;
+    bool insert_indicator_batch(const std::vector<IndicatorValue>& values) override;
+
+    bool load_ticks(const std::string& symbol, TickColumns& out) override;
+    bool mark_stored(std::vector<TickerData>& ticks, size_t& stored) override;
+
+    bool begin_transaction() override;
+    bool commit_transaction() override;
+    bool rollback_transaction() override;
+
+    // Existing partition files overlapping [from_ms, to_ms], oldest first
+    std::vector<DbPartition> partitions(long long from_ms, long long to_ms) const;
+
+    /**
+     * @brief Opens `reader` on the catalog with the partitions overlapping [from_ms, to_ms]
+     * attached, so plain SELECTs on the partitioned tables cover the whole range. Fails if
+     * the range spans more partitions than the reader can attach.
+     */
+    bool open_reader(PersistenceManager& reader, long long from_ms, long long to_ms) const;
+
+    long long interval_ms() const { return interval_ms_; }
+    std::string partition_path(long long start_ms) const;
+
+private:
+    PersistenceManager& catalog_;
+    const long long interval_ms_;
+    const std::string directory_;
+    std::string schema_;
+    DbConfig config_;
+
+    // Writer thread
+    std::map<long long, std::unique_ptr<PersistenceManager>> open_; // By interval start
+    std::map<long long, PersistenceManager*> touched_;              // Written in this transaction
+    bool in_transaction_ = false;
+    long long newest_;
+
+    // Shared with the background opener
+    std::mutex roll_mutex_;
+    std::condition_variable roll_cv_;
+    long long prepare_start_;                                           // Next partition to open ahead
+    long long opening_;                                                 // Being opened, lock released
+    long long writer_newest_;                                           // Newest start the writer opened or is opening
+    long long awaited_;                                                 // Writer waits for opening_ to finish
+    std::map<long long, std::unique_ptr<PersistenceManager>> prepared_; // Opened, not yet used
+    std::vector<std::unique_ptr<PersistenceManager>> retired_;          // To be closed
+    bool roll_stop_ = false;
+    std::thread roller_;
+
+    // Read side (mark_stored), opened on first use
+    PersistenceManager reader_;
+    std::vector<std::string> reader_files_;
+
+    std::unique_ptr<PersistenceManager> open_partition(long long start_ms);
+    PersistenceManager* partition_for(long long timestamp_ms);
+    void retire_old_partitions();
+    void roller_loop();
+
+    bool open_catalog_reader(PersistenceManager& reader) const;
+    // Calls `fn` with the attached window and the time range it covers, once per window
+    template <typename Fn>
+    bool for_each_window(PersistenceManager& reader, long long from_ms, long long to_ms, Fn fn);
+    template <typename Row, typename TimeOf, typename Insert>
+    bool route(const std::vector<Row>& rows, TimeOf time_of, Insert insert);
+};
+
+#endif // PARTITIONED_DATABASE_H
@@ -2,28 +2,196 @@
 #define PERSISTENCE_H
 
 #include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "TickerData.h"
+#include "CandleAggregator.h"
+#include "BatchIndicators.h"
 
 const std::string DB_FILE = "../db_setup/crypto_data.db";
 
-class PersistenceManager {
+// PRAGMA user_version of db_setup/schema.sql; open_db() migrates older files up to it
+const int SCHEMA_VERSION = 1;
+
+// Upper bound on rows bound into one multi-VALUES INSERT (also capped by SQLite's variable limit)
+const size_t MAX_ROWS_PER_INSERT = 128;
+
+/**
+ * @brief Connection settings applied by open_db(). Defaults favour ingest throughput:
+ * WAL (readers such as data_analyzer.py no longer block the engine), synchronous=NORMAL
+ * (durable at checkpoints, no fsync per COMMIT) and inline auto-checkpoints disabled in
+ * favour of the background checkpointer.
+ */
+struct DbConfig {
+    std::string journal_mode = "WAL";       // DELETE | TRUNCATE | PERSIST | MEMORY | WAL | OFF
+    std::string synchronous = "NORMAL";     // OFF | NORMAL | FULL | EXTRA
+    int page_size = 4096;                   // Only takes effect for a newly created database
+    int cache_size_kib = 64 * 1024;         // PRAGMA cache_size = -N
+    long long mmap_size = 256LL << 20;      // Bytes of the DB file to memory-map for reads
+    int wal_autocheckpoint = 0;             // Pages; 0 = leave checkpoints to the background thread
+    std::string temp_store = "MEMORY";      // DEFAULT | FILE | MEMORY
+    int busy_timeout_ms = 5000;
+
+    // Background checkpointer (WAL only): PASSIVE checkpoint every interval, escalating to
+    // TRUNCATE once the WAL exceeds checkpoint_truncate_bytes. 0 disables the thread.
+    int checkpoint_interval_ms = 1000;
+    long long checkpoint_truncate_bytes = 64LL << 20;
+};
+
+// One aggregated_metrics row, computed by ProcessingThread
+struct MetricRow {
+    long long timestamp_ms;
+    long long trade_id;
+    SymbolId symbol_id;
+    double vwap;
+    double simple_average;
+    double ema_20;
+    double ema_50;
+};
+
+// One indicator output outside the aggregated_metrics columns (indicator_values row)
+struct IndicatorValue {
+    long long timestamp_ms;
+    long long trade_id;
+    SymbolId symbol_id;
+    std::string_view name;  // Points into the IndicatorRegistry's output names
+    double value;
+};
+
+/**
+ * @brief What the writer and the backfill need from a storage engine. PersistenceManager
+ * keeps everything in SQLite; PartitionedDatabase spreads it over one SQLite file per
+ * time interval; ColumnarTickStore moves the raw trades into columnar segment files and
+ * delegates the rest to either.
+ */
+class PersistenceBackend {
+public:
+    virtual ~PersistenceBackend() = default;
+
+    virtual bool insert_raw_batch(const std::vector<TickerData>& rows) = 0;
+    virtual bool insert_metrics_batch(const std::vector<MetricRow>& rows, bool replace = false) = 0;
+    virtual bool insert_bars_batch(const std::vector<Candle>& bars) = 0;
+    virtual bool insert_indicator_batch(const std::vector<IndicatorValue>& values) = 0;
+
+    // Loads one symbol's trades in (open_time_ms, trade_id) order
+    virtual bool load_ticks(const std::string& symbol, TickColumns& out) = 0;
+
+    // Flags ticks that already have an aggregated_metrics row (written in the same commit
+    // as the trade, whichever backend holds the trades) with TICK_ALREADY_STORED; `stored` counts them
+    virtual bool mark_stored(std::vector<TickerData>& ticks, size_t& stored) = 0;
+
+    virtual bool begin_transaction() = 0;
+    virtual bool commit_transaction() = 0;
+    virtual bool rollback_transaction() = 0;
+};
+
+class PersistenceManager : public PersistenceBackend {
 private:
     void* db_handle; 
+    // Prepared once in open_db(), reset and rebound per row, finalized in close_db()
+    void* insert_raw_stmt_;
+    void* insert_metrics_stmt_;
+    // Multi-VALUES statements indexed by row count, prepared on first use of each size
+    std::vector<void*> raw_batch_stmts_;
+    std::vector<void*> metrics_batch_stmts_;
+    std::vector<void*> metrics_replace_stmts_;
+    std::vector<void*> bars_batch_stmts_;
+    std::vector<void*> indicator_batch_stmts_;
+    size_t rows_per_insert_;
     bool execute_sql(const char* sql);
+    bool prepare_statements();
+    void finalize_statements();
+    void* batch_statement(std::vector<void*>& cache, const char* insert_prefix, int columns, size_t rows,
+                          const char* insert_suffix = "");
+
+    bool apply_pragmas(const DbConfig& config);
+
+    // Background WAL checkpointer, running on its own connection
+    std::string db_path_;
+    DbConfig config_;
+    size_t attached_ = 0;   // Partitions attached as p0, p1, ...
+    std::vector<std::string> views_;
+    bool create_schema(const std::string& schema);
+    bool migrate_schema();
+
+    // symbols dimension: DB symbol_id per SymbolId, resolved through the catalog (itself
+    // unless set_symbol_catalog() was called); 0 = not resolved yet
+    PersistenceManager* symbol_catalog_;
+    std::mutex symbols_mutex_;
+    std::vector<long long> symbol_keys_;
+    std::vector<SymbolId> uncommitted_symbols_; // Added in the open transaction; forgotten on rollback
+    std::thread checkpoint_thread_;
+    std::mutex checkpoint_mutex_;
+    std::condition_variable checkpoint_cv_;
+    bool checkpoint_stop_ = false;
+    void start_checkpointer();
+    void stop_checkpointer();
+    void checkpoint_loop();
 
 public:
     PersistenceManager();
-    ~PersistenceManager();
+    ~PersistenceManager() override;
 
-    bool open_db();
+    // `schema` (CREATE statements, see table_schema()) initializes a file that has no tables yet
+    bool open_db(const std::string& path = DB_FILE, const DbConfig& config = DbConfig(), const std::string& schema = "");
     void close_db();
+    bool is_open() const { return db_handle != nullptr; }
+    const std::string& path() const { return db_path_; }
+
+    /**
+     * @brief Partition files keep no symbols table: their rows use the catalog's symbol
+     * ids, and an older partition is migrated with the catalog attached. Call before open_db().
+     */
+    void set_symbol_catalog(PersistenceManager& catalog) { symbol_catalog_ = &catalog; }
+
+    // symbol_id of `id` in this database's symbols table, adding the symbol if `create`;
+    // 0 if it is not there (or could not be added)
+    long long symbol_key(SymbolId id, bool create);
+
+    // Rewrites the file to return its free pages to the OS (after a migration or large deletes);
+    // refuses if the disk lacks room for the copy VACUUM makes. Blocks writers while it runs.
+    bool vacuum();
+
+    // PRAGMA user_version of the file at `path` without opening it for writing; -1 if unreadable
+    static int schema_version(const std::string& path);
+
+    // CREATE statements of `tables` and their indexes, as stored in this database
+    bool table_schema(const std::vector<std::string>& tables, std::string& sql);
+
+    /**
+     * @brief Read-side view over partition files: ATTACHes `files` (detaching the previous
+     * set) and shadows each of `tables` with a TEMP view that UNION ALLs its copies, so the
+     * reads below (load_ticks, mark_stored, ad-hoc SELECTs) span every attached partition.
+     * At most max_attached() files; do not write through a connection used this way.
+     */
+    bool attach_partitions(const std::vector<std::string>& files, const std::vector<std::string>& tables);
+    size_t max_attached();
 
     bool insert_raw_data(const TickerData& data);
     bool insert_metrics(long long timestamp, long long trade_id, const std::string& symbol, double vwap, double simple_avg, double ema_20, double ema_50);
 
-    bool begin_transaction();
-    bool commit_transaction();
-    bool rollback_transaction();
+    // Insert whole batches in chunks of up to rows_per_insert() rows per statement execution
+    bool insert_raw_batch(const std::vector<TickerData>& rows) override;
+    // `replace` overwrites existing rows (recompute) instead of ignoring them
+    bool insert_metrics_batch(const std::vector<MetricRow>& rows, bool replace = false) override;
+    // Closed bars are upserted: a bucket written in two parts (e.g. across a restart) is merged
+    bool insert_bars_batch(const std::vector<Candle>& bars) override;
+    bool insert_indicator_batch(const std::vector<IndicatorValue>& values) override;
+    size_t rows_per_insert() const { return rows_per_insert_; }
+
+    bool load_ticks(const std::string& symbol, TickColumns& out) override;
+
+    bool mark_stored(std::vector<TickerData>& ticks, size_t& stored) override;
+
+    // Highest journal sequence committed to this database (journal_state; 0 if none)
+    bool load_journal_watermark(uint64_t& sequence);
+    bool save_journal_watermark(uint64_t sequence);
+
+    bool begin_transaction() override;
+    bool commit_transaction() override;
+    bool rollback_transaction() override;
 };
 
 #endif // PERSISTENCE_H
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef PERSISTENCE_WRITER_H
+#define PERSISTENCE_WRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Constants.h"
+#include "Persistence.h"
+
+// A fully computed batch, ready to be written in one go
+struct WriteBatch {
+    std::vector<TickerData> raw;
+    std::vector<MetricRow> metrics;
+    std::vector<Candle> bars;       // Bars closed by this batch's trades
+    std::vector<IndicatorValue> indicators; // Configured outputs beyond the metrics columns
+};
+
+/**
+ * @brief Persistence stage running on its own thread.
+ *
+ * ProcessingThread hands over computed batches with submit() and goes straight back to
+ * indicator computation. The writer takes every batch queued since its last commit and
+ * writes them in a single transaction (group commit), so a slow COMMIT/fsync delays only
+ * the writer. At most `max_in_flight` batches may be queued or being written; beyond
+ * that submit() blocks, pushing backpressure up to the ingest queue instead of growing
+ * memory without bound.
+ */
+class PersistenceWriter {
+private:
+    PersistenceBackend& db_manager_;
+    const size_t max_in_flight_;
+
+    std::deque<WriteBatch> pending_;
+    size_t in_flight_ = 0;          // Queued + currently being written
+    size_t failed_groups_ = 0;      // Group commits rolled back
+    bool running_ = false;
+    std::mutex mutex_;
+    std::condition_variable has_work_;
+    std::condition_variable has_room_;
+    std::thread thread_;
+
+    void writer_loop();
+    bool write_group(std::vector<WriteBatch>& group);
+
+public:
+    PersistenceWriter(PersistenceBackend& db_mgr, size_t max_in_flight = MAX_IN_FLIGHT_BATCHES);
+    ~PersistenceWriter();
+
+    void start_thread();
+
+    // Writes everything still queued, then stops the writer thread
+    void stop_thread();
+
+    // Queues a batch for writing; blocks while max_in_flight batches are outstanding
+    void submit(WriteBatch&& batch);
+
+    size_t in_flight();
+
+    // Group commits rolled back so far; while non-zero the journal watermark stays put
+    size_t failed_groups();
+};
+
+#endif // PERSISTENCE_WRITER_H
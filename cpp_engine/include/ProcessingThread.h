@@ -2,32 +2,38 @@
 #define PROCESSING_THREAD_H
 
 #include <thread>
+#include <atomic>
 #include <iostream>
 #include "SafeQueue.h"
-#include "Persistence.h"
+#include "PersistenceWriter.h"
+#include "FlatSymbolMap.h"
+#include "CandleAggregator.h"
+#include "Indicators.h"
+#include "TickProcessor.h"
 
 class ProcessingThread {
 private:
     SafeQueue<TickerData>& data_queue_;
-    PersistenceManager& db_manager_;
+    PersistenceWriter& writer_;
+    const size_t shard_;                          // Index of the symbol shard this thread owns
     std::thread thread_;
-    bool running_ = false;
+    std::atomic<bool> running_{false};
     void process_and_insert_batch(const std::vector<TickerData>& batch);
-    double last_ema_value_20_ = 0.0;
-    bool is_first_ema_20_ = true;
-    const int EMA_PERIOD_20 = 20;
-    double last_ema_value_50_ = 0.0;
-    bool is_first_ema_50_ = true;
-    const int EMA_PERIOD_50 = 50;
+    TickProcessor processor_;
+    FlatSymbolMap<IndicatorSet> indicator_state_; // Keyed by interned symbol id
+    CandleAggregator candles_;
+    std::vector<Candle> stored_bars_;             // Scratch for bars closed by TICK_ALREADY_STORED ticks
     void process_data_loop();
 
 public:
-    ProcessingThread(SafeQueue<TickerData>& queue, PersistenceManager& db_mgr);
+    // `indicators` must be configured and outlive the thread. `queue` carries only the
+    // symbols of `shard`, so indicator and bar state is never shared between threads.
+    ProcessingThread(SafeQueue<TickerData>& queue, PersistenceWriter& writer, const IndicatorRegistry& indicators,
+                     size_t shard = 0);
     ~ProcessingThread();
 
     void start_thread();
     void stop_thread();
-    double calculate_ema(double current_price, int period);
 };
 
 #endif // PROCESSING_THREAD_H
\ No newline at end of file
@@ -0,0 +1,94 @@
+// File: /cpp_engine/include/RetentionCompactor.h
+
+#ifndef RETENTION_COMPACTOR_H
+#define RETENTION_COMPACTOR_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Constants.h"
+#include "Persistence.h"
+
+class PartitionedDatabase;
+
+// What the compactor keeps; a retention of 0 keeps that table at full resolution forever
+struct RetentionPolicy {
+    long long tick_retention_ms = 0;      // Older raw trades are rolled into RETENTION_BAR_INTERVAL_MS bars and deleted
+    long long metric_retention_ms = 0;    // Older metrics / indicator values are thinned to one row per resolution bucket
+    long long metric_resolution_ms = RETENTION_METRIC_RESOLUTION_MS;
+    size_t chunk_rows = RETENTION_CHUNK_ROWS;
+    int chunk_pause_ms = RETENTION_CHUNK_PAUSE_MS;
+    int interval_ms = RETENTION_INTERVAL_MS;
+
+    bool enabled() const { return tick_retention_ms > 0 || metric_retention_ms > 0; }
+};
+
+struct RetentionStats {
+    uint64_t trades_deleted = 0;
+    uint64_t bars_added = 0;              // Bars missing from ohlcv_bars, rebuilt from the deleted trades
+    uint64_t metrics_deleted = 0;
+    uint64_t indicator_values_deleted = 0;
+    uint64_t bytes_freed = 0;             // Pages put on the files' free lists (reused by later inserts)
+    uint64_t bytes_returned = 0;          // How much smaller the files got (VACUUM / incremental_vacuum)
+    size_t chunks = 0;
+};
+
+/**
+ * @brief Background job enforcing a RetentionPolicy on the SQLite tables.
+ *
+ * Raw trades older than the tick retention are rolled into 1m bars (INSERT OR IGNORE:
+ * the bars the engine built live win, the rollup only fills gaps such as data from
+ * before ohlcv_bars existed) and deleted. aggregated_metrics rows older than the metric
+ * retention are thinned to the last row of each symbol and resolution bucket, which for
+ * running indicators (VWAP, EMA) is the value at the bucket's close; the indicator_values
+ * of the dropped trades go with them. A watermark per file (retention_state) records how
+ * far metrics have been thinned.
+ *
+ * Work is done on a separate connection in transactions of about chunk_rows rows each
+ * (BEGIN IMMEDIATE, whole buckets only) with a pause in between, so the writer's group
+ * commits wait at most one chunk. With partitions every file older than the cutoff is
+ * compacted on its own, and a partition whose whole interval has expired is VACUUMed
+ * afterwards, returning the space to the OS without touching the live file. A single DB
+ * only returns space if it uses auto_vacuum=INCREMENTAL; otherwise the freed pages are
+ * reused by new rows, so the file stops growing.
+ *
+ * Journal replay and recompute only see what is left: keep retention well above the
+ * time between clean shutdowns. Trades in columnar segments (--tick-store columnar) are
+ * not touched.
+ */
+class RetentionCompactor {
+public:
+    // `partitioned`: compact its partition files instead of `db_path`
+    RetentionCompactor(const RetentionPolicy& policy, const std::string& db_path = DB_FILE,
+                       const PartitionedDatabase* partitioned = nullptr);
+    ~RetentionCompactor();
+
+    RetentionCompactor(const RetentionCompactor&) = delete;
+    RetentionCompactor& operator=(const RetentionCompactor&) = delete;
+
+    // Runs a pass right away and then every policy.interval_ms
+    void start();
+    void stop();
+
+    // One pass over every file, relative to the current time; false if a file failed
+    bool run_once(RetentionStats& stats);
+
+private:
+    const RetentionPolicy policy_;
+    const std::string db_path_;
+    const PartitionedDatabase* partitioned_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+
+    bool stopping();
+    void compactor_loop();
+    bool compact_file(const std::string& path, long long tick_cutoff_ms, long long metric_cutoff_ms, bool vacuum,
+                      RetentionStats& stats);
+};
+
+#endif // RETENTION_COMPACTOR_H
@@ -1,81 +1,229 @@
 #ifndef SAFE_QUEUE_H
 #define SAFE_QUEUE_H
 
-#include <queue>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
 #include <optional>
-#include "TickerData.h" 
+#include <thread>
+#include <vector>
+#include "Constants.h"
+#include "TickerData.h"
+
+// Keeps independently written counters on separate cache lines
+constexpr size_t CACHE_LINE_SIZE = 64;
 
 /**
- * @brief Thread-safe queue for TickerData. 
- * This is crucial for safely passing data between the Data Ingestor thread 
- * and the Processing thread without data corruption.
+ * @brief Bounded lock-free multi-producer / single-consumer ring for passing ticks
+ * from the ingest threads to the Processing thread.
+ *
+ * Each slot carries a sequence number (Vyukov's bounded queue): producers claim a slot
+ * with one CAS on the enqueue cursor and publish it with a release store, the single
+ * consumer reads slots in order without any atomic RMW. When the ring is full push()
+ * yields until the consumer frees a slot (backpressure instead of unbounded growth).
+ *
+ * The mutex/condition variable are only touched to park an idle consumer; producers
+ * check a flag and skip them entirely while the consumer is busy.
  */
 template <typename T>
 class SafeQueue {
 private:
-    std::queue<TickerData> queue_;
-    mutable std::mutex mutex_;
-    std::condition_variable condition_;
-    bool stop_flag_ = false;
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    const size_t mask_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> consumer_parked_{false};
+    std::atomic<bool> stop_flag_{false};
+    std::atomic<bool> interrupt_flag_{false};
+    std::mutex park_mutex_;
+    std::condition_variable park_condition_;
+
+    static size_t round_up_pow2(size_t n) {
+        size_t capacity = 2;
+        while (capacity < n) capacity <<= 1;
+        return capacity;
+    }
+
+    // Claims a slot, blocking (yield) while the ring is full
+    Cell& claim_slot(size_t& pos) {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    return cell;
+                }
+            } else if (diff < 0) {
+                std::this_thread::yield(); // Full: wait for the consumer
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void wake_consumer() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumer_parked_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(park_mutex_);
+            park_condition_.notify_one();
+        }
+    }
+
+    bool front_ready() const {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].sequence.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    size_t drain_into(std::vector<T>& out, size_t max) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        size_t popped = 0;
+        while (popped < max) {
+            Cell& cell = cells_[pos & mask_];
+            if (cell.sequence.load(std::memory_order_acquire) != pos + 1) break;
+            out.push_back(std::move(cell.data));
+            cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+            ++pos;
+            ++popped;
+        }
+        dequeue_pos_.store(pos, std::memory_order_relaxed);
+        return popped;
+    }
 
 public:
+    explicit SafeQueue(size_t capacity = QUEUE_CAPACITY)
+        : cells_(new Cell[round_up_pow2(capacity)]), mask_(round_up_pow2(capacity) - 1) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    SafeQueue(const SafeQueue&) = delete;
+    SafeQueue& operator=(const SafeQueue&) = delete;
+
     // Destructor is needed to unblock waiting threads upon shutdown
     ~SafeQueue() {
         stop_flag_ = true;
-        condition_.notify_all(); 
+        std::lock_guard<std::mutex> lock(park_mutex_);
+        park_condition_.notify_all();
     }
 
+    size_t capacity() const { return mask_ + 1; }
+
     /**
-     * @brief Pushes data onto the queue.
-     * @param data The TickerData object to push.
+     * @brief Pushes data onto the queue (any thread). Blocks while the ring is full.
+     * @param data The item to push.
      */
-    void push(const TickerData& data) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        queue_.push(data);
-        condition_.notify_one(); // Notify one waiting thread that data is available
+    void push(const T& data) {
+        size_t pos;
+        Cell& cell = claim_slot(pos);
+        cell.data = data;
+        cell.sequence.store(pos + 1, std::memory_order_release);
+        wake_consumer();
+    }
+
+    void push(T&& data) {
+        size_t pos;
+        Cell& cell = claim_slot(pos);
+        cell.data = std::move(data);
+        cell.sequence.store(pos + 1, std::memory_order_release);
+        wake_consumer();
     }
 
     /**
-     * @brief Pops data from the queue, blocking if the queue is empty.
-     * @return std::optional<TickerData> The data, or empty if stop_flag is set.
+     * @brief Pushes a whole decoded batch with a single consumer wake-up.
+     * @param batch Items to append; moved from, left empty.
      */
-    std::optional<TickerData> pop() {
-        std::unique_lock<std::mutex> lock(mutex_);
-        
-        // Wait until the queue is not empty OR the stop flag is set
-        condition_.wait(lock, [this] {
-            return !queue_.empty() || stop_flag_;
-        });
-
-        if (stop_flag_ && queue_.empty()) {
-            return std::nullopt; // System is shutting down
+    void push_bulk(std::vector<T>& batch) {
+        if (batch.empty()) return;
+        for (auto& data : batch) {
+            size_t pos;
+            Cell& cell = claim_slot(pos);
+            cell.data = std::move(data);
+            cell.sequence.store(pos + 1, std::memory_order_release);
         }
-
-        // Extract the data
-        TickerData data = std::move(queue_.front());
-        queue_.pop();
-        return data;
+        batch.clear();
+        wake_consumer();
     }
 
     /**
-     * @brief Pokušava izvući element iz reda bez blokiranja.
-     * @return std::optional<T> Element ako postoji, inače std::nullopt.
+     * @brief Pops the next item without blocking (consumer thread only).
+     * @return std::optional<T> Item if one is ready, otherwise std::nullopt.
      */
     std::optional<T> try_pop() {
-        std::unique_lock<std::mutex> lock(mutex_);
-        
-        // Jednostavno provjeri red, bez čekanja na condition_variable
-        if (queue_.empty()) {
-            // Nema elementa, vrati prazan optional
-            return std::nullopt; 
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[pos & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+            return std::nullopt;
+        }
+        std::optional<T> value(std::move(cell.data));
+        cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+        dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+        return value;
+    }
+
+    /**
+     * @brief Moves up to `max` ready items into `out` (consumer thread only). If none are
+     * ready, blocks until data arrives, `deadline` passes, interrupt() is called or the
+     * queue shuts down; one wake-up then drains everything available up to `max`.
+     * @return Number of items appended to `out`.
+     */
+    template <typename Clock, typename Duration>
+    size_t pop_bulk(std::vector<T>& out, size_t max, std::chrono::time_point<Clock, Duration> deadline) {
+        size_t popped = drain_into(out, max);
+        if (popped > 0 || max == 0) return popped;
+
+        {
+            std::unique_lock<std::mutex> lock(park_mutex_);
+            consumer_parked_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            park_condition_.wait_until(lock, deadline, [this] {
+                return front_ready() || stop_flag_ || interrupt_flag_;
+            });
+            consumer_parked_.store(false, std::memory_order_relaxed);
+            interrupt_flag_ = false;
+        }
+        return drain_into(out, max);
+    }
+
+    /**
+     * @brief Wakes a consumer blocked in pop_bulk() without stopping the queue
+     * (used to make the consumer re-check its own shutdown flag).
+     */
+    void interrupt() {
+        std::lock_guard<std::mutex> lock(park_mutex_);
+        interrupt_flag_ = true;
+        park_condition_.notify_all();
+    }
+
+    /**
+     * @brief Pops data from the queue, blocking if the queue is empty (consumer thread only).
+     * @return std::optional<T> The data, or empty if the queue is shutting down.
+     */
+    std::optional<T> pop() {
+        while (true) {
+            std::optional<T> value = try_pop();
+            if (value || stop_flag_) return value;
+
+            std::unique_lock<std::mutex> lock(park_mutex_);
+            consumer_parked_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            park_condition_.wait(lock, [this] { return front_ready() || stop_flag_; });
+            consumer_parked_.store(false, std::memory_order_relaxed);
         }
-        // Stvori i vrati std::optional koji sadrži izvađeni element
-        T value = queue_.front();
-        queue_.pop();
-        return std::optional<T>(value); // Ispravan povratak
     }
 };
 
-#endif 
\ No newline at end of file
+#endif // SAFE_QUEUE_H
@@ -0,0 +1,75 @@
+// File: /cpp_engine/include/ShardRouter.h
+
+#ifndef SHARD_ROUTER_H
+#define SHARD_ROUTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Constants.h"
+#include "SafeQueue.h"
+#include "SymbolTable.h"
+#include "TickerData.h"
+#include "TickSink.h"
+
+/**
+ * @brief Splits the tick stream across processing shards by symbol.
+ *
+ * Each shard has its own ingest queue and is drained by one ProcessingThread. A symbol
+ * always hashes to the same shard and every producer pushes its ticks in arrival order,
+ * so trades of one symbol reach their indicators in order. Symbols on different shards
+ * are processed in parallel.
+ */
+class ShardRouter : public TickSink {
+public:
+    explicit ShardRouter(size_t shards, size_t queue_capacity = QUEUE_CAPACITY) {
+        if (shards == 0) shards = 1;
+        // The ring memory is split across shards rather than multiplied by them
+        size_t per_shard = queue_capacity / shards;
+        if (per_shard < MIN_SHARD_QUEUE_CAPACITY) per_shard = MIN_SHARD_QUEUE_CAPACITY;
+        for (size_t i = 0; i < shards; ++i) {
+            queues_.push_back(std::make_unique<SafeQueue<TickerData>>(per_shard));
+        }
+    }
+
+    ShardRouter(const ShardRouter&) = delete;
+    ShardRouter& operator=(const ShardRouter&) = delete;
+
+    size_t shard_count() const { return queues_.size(); }
+
+    size_t shard_of(SymbolId id) const {
+        // Fibonacci hash, then scale the 32-bit result onto [0, shards) without a division
+        uint32_t hash = static_cast<uint32_t>(id * 0x9E3779B9u);
+        return static_cast<size_t>((static_cast<uint64_t>(hash) * queues_.size()) >> 32);
+    }
+
+    SafeQueue<TickerData>& queue(size_t shard) { return *queues_[shard]; }
+
+    /**
+     * @brief Moves every tick in `batch` onto its shard's queue, with one consumer
+     * wake-up per shard touched. `batch` is left empty.
+     */
+    void push_bulk(std::vector<TickerData>& batch) override {
+        if (batch.empty()) return;
+        if (queues_.size() == 1) {
+            queues_[0]->push_bulk(batch);
+            return;
+        }
+        // One pending batch per shard, per ingest thread; reused across calls
+        thread_local std::vector<std::vector<TickerData>> scratch;
+        scratch.resize(queues_.size());
+        for (const TickerData& tick : batch) {
+            scratch[shard_of(tick.symbol_id)].push_back(tick);
+        }
+        batch.clear();
+        for (size_t i = 0; i < queues_.size(); ++i) {
+            queues_[i]->push_bulk(scratch[i]);
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<SafeQueue<TickerData>>> queues_;
+};
+
+#endif // SHARD_ROUTER_H
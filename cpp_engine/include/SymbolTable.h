@@ -0,0 +1,59 @@
+// File: /cpp_engine/include/SymbolTable.h
+
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using SymbolId = uint32_t;
+constexpr SymbolId INVALID_SYMBOL = UINT32_MAX;
+constexpr size_t MAX_SYMBOLS = 1 << 16;
+
+/**
+ * @brief Process-wide symbol interning: "BTCUSDT" <-> dense integer id (0, 1, 2, ...).
+ *
+ * Symbols are interned once at ingest; everything downstream keys state by id. Ids are
+ * only meaningful inside one engine process. intern() takes a mutex (ingest threads
+ * cache their last lookup), name() is lock-free and the returned view stays valid for
+ * the lifetime of the process.
+ */
+class SymbolTable {
+private:
+    std::unique_ptr<std::string[]> names_;        // Fixed capacity so readers never see a reallocation
+    std::atomic<size_t> count_{0};
+    std::unordered_map<std::string_view, SymbolId> ids_; // Keys view into names_
+    std::mutex mutex_;
+
+    SymbolTable();
+
+public:
+    static SymbolTable& instance();
+
+    // Returns the id for `symbol`, assigning the next free one on first sight
+    SymbolId intern(std::string_view symbol);
+
+    // Returns INVALID_SYMBOL if `symbol` was never interned
+    SymbolId find(std::string_view symbol);
+
+    std::string_view name(SymbolId id) const {
+        return id < count_.load(std::memory_order_acquire) ? std::string_view(names_[id]) : std::string_view();
+    }
+
+    size_t size() const { return count_.load(std::memory_order_acquire); }
+};
+
+inline SymbolId intern_symbol(std::string_view symbol) {
+    return SymbolTable::instance().intern(symbol);
+}
+
+inline std::string_view symbol_name(SymbolId id) {
+    return SymbolTable::instance().name(id);
+}
+
+#endif // SYMBOL_TABLE_H
@@ -0,0 +1,39 @@
+// File: /cpp_engine/include/TickCodec.h
+
+#ifndef TICK_CODEC_H
+#define TICK_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Time-series codecs for one column of one tick block.
+ *
+ * Every encoded column starts with a TickCodecId byte, so decode_column() can pick the
+ * decoder and each block may use a different codec. Encoders append to `out`; decoders
+ * read from `in` and may read up to 8 bytes past the end of the stream, so the caller
+ * keeps that much padding after the last column of a buffer.
+ */
+enum TickCodecId : uint8_t {
+    TICK_CODEC_RAW = 0,          // 8-byte values as they are
+    TICK_CODEC_DELTA_DELTA = 1,  // Integers: delta-of-delta in variable-length buckets (Gorilla timestamps)
+    TICK_CODEC_XOR = 2,          // Doubles: XOR with the previous value, meaningful bits only (Gorilla values)
+    TICK_CODEC_FIXED_POINT = 3   // Doubles with few decimals: scaled integers, bit-packed deltas
+};
+
+// Nearly monotonic integers (timestamps, trade ids): about 1 bit per value for a constant step
+void encode_delta_delta(const long long* values, size_t n, std::vector<uint8_t>& out);
+
+// Any doubles; values equal to their predecessor cost 1 bit
+void encode_xor(const double* values, size_t n, std::vector<uint8_t>& out);
+
+// Stores the doubles as integers scaled by 10^d, with the smallest d <= max_decimals that
+// gives back every value bit for bit. Returns false, writing nothing, if there is none.
+bool encode_fixed_point(const double* values, size_t n, int max_decimals, std::vector<uint8_t>& out);
+
+// Decodes `n` 8-byte values (int64 or double bits, as encoded) into `out`;
+// returns the number of bytes consumed, or 0 for an unknown codec
+size_t decode_column(const uint8_t* in, size_t n, void* out);
+
+#endif // TICK_CODEC_H
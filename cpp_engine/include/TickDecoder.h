@@ -0,0 +1,57 @@
+// File: /cpp_engine/include/TickDecoder.h
+
+#ifndef TICK_DECODER_H
+#define TICK_DECODER_H
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+#include "TickerData.h"
+
+/**
+ * @brief Batch decoder for a reassembled receive buffer of CSV ticks.
+ *
+ * Pass 1 indexes every ',' and '\n' with the widest SIMD kernel the CPU supports.
+ * Pass 2 walks the index line by line: fields in the fixed `%.8f` layout produced by
+ * binance_data_fetcher.py go through a SWAR digit kernel, anything else falls back to
+ * the from_chars parser, so results are identical to parseTickerData either way.
+ */
+class TickDecoder {
+public:
+    enum class Kernel { Scalar, SSE2, AVX2 };
+
+    using ErrorHandler = std::function<void(std::string_view line, ParseStatus status)>;
+
+    TickDecoder();
+
+    Kernel kernel() const { return kernel_; }
+    static const char* kernel_name(Kernel kernel);
+
+    // Forces a specific delimiter kernel (benchmarks); ignored if the CPU lacks it
+    void set_kernel(Kernel kernel);
+
+    // Called once per malformed line; lines are otherwise skipped silently
+    void set_error_handler(ErrorHandler handler) { on_error_ = std::move(handler); }
+
+    /**
+     * @brief Decodes every line in `buffer` and appends the ticks to `out`.
+     * A trailing line without '\n' is decoded as well.
+     * @return Number of malformed lines.
+     */
+    size_t decode(std::string_view buffer, std::vector<TickerData>& out);
+
+private:
+    Kernel kernel_;
+    ErrorHandler on_error_;
+    std::vector<uint32_t> delimiters_; // Offsets of ',' and '\n', reused across calls
+
+    // A connection almost always repeats one symbol: skip the symbol table for repeats
+    std::string last_symbol_;
+    SymbolId last_symbol_id_ = INVALID_SYMBOL;
+
+    void index_delimiters(std::string_view buffer);
+    bool decode_line(const char* line, const uint32_t* commas, const char* line_end, TickerData& out);
+};
+
+#endif // TICK_DECODER_H
@@ -0,0 +1,151 @@
+// File: /cpp_engine/include/TickJournal.h
+
+#ifndef TICK_JOURNAL_H
+#define TICK_JOURNAL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Constants.h"
+#include "MappedFile.h"
+#include "TickSink.h"
+#include "TickerData.h"
+
+// --- On-disk format ---
+
+constexpr char JOURNAL_MAGIC[8] = {'T', 'K', 'J', 'R', 'N', 'L', '0', '1'};
+constexpr size_t JOURNAL_SYMBOL_BYTES = 16;
+
+// First 64 bytes of every segment file
+struct JournalSegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t first_sequence;    // Sequence number of record 0
+    uint64_t capacity;          // Records the segment was sized for
+    uint8_t reserved[32];
+};
+static_assert(sizeof(JournalSegmentHeader) == 64, "JournalSegmentHeader must stay 64 bytes");
+
+/**
+ * @brief One journaled trade. Fixed size, so record i of a segment sits at a known
+ * offset and has sequence first_sequence + i. The symbol is stored by name because
+ * interned ids are only meaningful inside one process.
+ */
+struct JournalRecord {
+    uint32_t crc;               // CRC-32C of the sequence number and the rest of the record
+    uint32_t symbol_length;
+    long long timestamp_ms;
+    long long trade_id;
+    char symbol[JOURNAL_SYMBOL_BYTES];
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+};
+static_assert(sizeof(JournalRecord) == 80, "JournalRecord must stay 80 bytes");
+
+/**
+ * @brief Write-ahead journal of every tick accepted at ingest.
+ *
+ * Ticks are appended as fixed-size records to memory-mapped segment files named after
+ * their first sequence number, e.g. "ticks-00000000000001048577.journal". Each segment
+ * is pre-sized to JOURNAL_SEGMENT_RECORDS records, so an append is a memcpy into the
+ * mapping under a short lock. A background thread msyncs and fdatasyncs the newly
+ * written range every JOURNAL_SYNC_INTERVAL_MS, so a crash loses at most that window
+ * of ticks. A record that fails its CRC (a torn or unwritten slot) marks the end of a
+ * segment's valid data.
+ */
+class TickJournal {
+public:
+    explicit TickJournal(const std::string& directory = JOURNAL_DIR,
+                         size_t segment_records = JOURNAL_SEGMENT_RECORDS);
+    ~TickJournal();
+
+    TickJournal(const TickJournal&) = delete;
+    TickJournal& operator=(const TickJournal&) = delete;
+
+    // Finds the last valid record, trims the newest segment to it, opens a fresh segment
+    // after it and starts the sync thread
+    bool open();
+
+    // Syncs everything appended and releases the segment
+    void close();
+
+    // Thread-safe. Symbols longer than JOURNAL_SYMBOL_BYTES cannot be journaled and are
+    // counted in skipped_ticks().
+    void append(const std::vector<TickerData>& ticks);
+
+    // Highest sequence number written so far (0 if the journal is empty)
+    uint64_t last_sequence();
+    size_t skipped_ticks();
+
+    // Deletes segments holding only records <= `committed_through`, keeping the newest
+    // `keep` segments for offline replay
+    void prune(uint64_t committed_through, size_t keep = JOURNAL_RETAIN_SEGMENTS);
+
+    const std::string& directory() const { return directory_; }
+
+private:
+    std::string directory_;
+    size_t segment_records_;
+
+    std::mutex mutex_;
+    std::shared_ptr<MappedFile> segment_;               // Guarded by mutex_
+    std::vector<std::shared_ptr<MappedFile>> retired_;  // Full segments awaiting their final sync
+    uint64_t segment_first_ = 1;
+    size_t segment_used_ = 0;                           // Records written to segment_
+    size_t segment_synced_ = 0;                         // Records of segment_ known to be on disk
+    uint64_t next_sequence_ = 1;
+    size_t skipped_ = 0;
+
+    std::thread sync_thread_;
+    std::condition_variable sync_cv_;
+    bool stop_ = false;
+
+    bool start_segment(uint64_t first_sequence);
+    void sync_loop();
+    void sync_now();
+};
+
+// Decorator that journals each batch before handing it to the processing stage
+class JournalingSink : public TickSink {
+public:
+    JournalingSink(TickJournal& journal, TickSink& next) : journal_(journal), next_(next) {}
+
+    void push_bulk(std::vector<TickerData>& batch) override {
+        journal_.append(batch);
+        next_.push_bulk(batch);
+    }
+
+private:
+    TickJournal& journal_;
+    TickSink& next_;
+};
+
+// --- Reading ---
+
+struct JournalScanStats {
+    size_t segments = 0;
+    size_t records = 0;         // Valid records read (including those <= the start sequence)
+    size_t bad_segments = 0;    // Unreadable headers
+    uint64_t last_sequence = 0;
+    size_t bytes = 0;           // Valid record bytes scanned
+};
+
+/**
+ * @brief Reads every valid record with a sequence number above `after`, in sequence
+ * order, handing them to `fn` in batches of up to `batch_size` ticks (symbols are
+ * interned on the way). Stops early and returns false if `fn` returns false.
+ */
+bool scan_journal(const std::string& directory, uint64_t after, size_t batch_size,
+                  const std::function<bool(std::vector<TickerData>& batch)>& fn, JournalScanStats& stats);
+
+#endif // TICK_JOURNAL_H
@@ -0,0 +1,38 @@
+// File: /cpp_engine/include/TickProcessor.h
+
+#ifndef TICK_PROCESSOR_H
+#define TICK_PROCESSOR_H
+
+#include <vector>
+#include "Indicators.h"
+#include "PersistenceWriter.h"
+
+/**
+ * @brief Per-tick indicator step shared by the processing schedulers.
+ *
+ * Runs one symbol's IndicatorSet over a tick and appends the resulting rows to a
+ * WriteBatch: the aggregated_metrics row, plus an indicator_values row for every
+ * other configured output that is warmed up. Holds only scratch space, so each
+ * processing thread owns one.
+ */
+class TickProcessor {
+private:
+    const IndicatorRegistry& indicators_;
+    std::vector<double> outputs_;                 // Scratch: one tick's values, by output index
+    std::vector<size_t> extra_outputs_;           // Outputs stored in indicator_values
+    size_t vwap_output_, sma_output_, ema_20_output_, ema_50_output_;
+
+    void update(const TickerData& tick, IndicatorSet& state);
+
+public:
+    // `indicators` must be configured and outlive the processor
+    explicit TickProcessor(const IndicatorRegistry& indicators);
+
+    // `state` belongs to tick.symbol_id and is created on first use
+    void process(const TickerData& tick, IndicatorSet& state, WriteBatch& out);
+
+    // Advances `state` without producing rows (replay of ticks that are already stored)
+    void warm_up(const TickerData& tick, IndicatorSet& state) { update(tick, state); }
+};
+
+#endif // TICK_PROCESSOR_H
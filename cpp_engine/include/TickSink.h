@@ -0,0 +1,22 @@
+// File: /cpp_engine/include/TickSink.h
+
+#ifndef TICK_SINK_H
+#define TICK_SINK_H
+
+#include <vector>
+#include "TickerData.h"
+
+/**
+ * @brief Where the ingestor delivers decoded ticks: the processing stage's entry point.
+ * Implemented by ShardRouter (static symbol shards) and WorkStealingExecutor.
+ */
+class TickSink {
+public:
+    virtual ~TickSink() = default;
+
+    // Takes every tick in `batch` (left empty), keeping each symbol's ticks in order.
+    // Called concurrently by all ingest threads.
+    virtual void push_bulk(std::vector<TickerData>& batch) = 0;
+};
+
+#endif // TICK_SINK_H
@@ -5,14 +5,20 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <vector>
 #include <ctime>
+#include <type_traits>
+#include "SymbolTable.h"
 
-// Structure to hold one candlestick (OHLCV) data point
+// Structure to hold one candlestick (OHLCV) data point.
+// Trivially copyable and exactly 64 bytes: the symbol travels as its interned id, so
+// ticks move through the queue and batches with plain memcpy (name via symbol()).
 struct TickerData {
     long long timestamp_ms; 
-    std::string symbol;     // e.g., "BTCUSDT"
+    SymbolId symbol_id;     // Interned id of e.g. "BTCUSDT", assigned by the parser
+    uint32_t flags;         // TICK_* bits below; 0 for live ticks
     long long trade_id;
     double open;
     double high;
@@ -20,6 +26,8 @@ struct TickerData {
     double close;
     double volume;
 
+    std::string_view symbol() const { return symbol_name(symbol_id); }
+
     /**
      * @brief Utility function to print the data struct. 
      * Defined inline because it's in a header file.
@@ -30,13 +38,43 @@ struct TickerData {
         std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", std::localtime(&t));
         
         std::cout << "Time: " << buffer
-                  << " | Symbol: " << symbol
+                  << " | Symbol: " << symbol()
                   << " | Close: " << close
                   << " | Volume: " << volume
                   << std::endl;
     }
 };
 
+// Set by journal replay on ticks already stored in the DB: processing rebuilds indicator
+// and open-bar state from them but writes nothing
+constexpr uint32_t TICK_ALREADY_STORED = 1u << 0;
+
+static_assert(std::is_trivially_copyable<TickerData>::value, "TickerData must stay memcpy-able");
+static_assert(sizeof(TickerData) == 64, "TickerData must fill exactly one cache line");
+
+/**
+ * @brief Outcome of the allocation-free parser; anything but Ok names the failing field.
+ */
+enum class ParseStatus {
+    Ok,
+    FieldCount,
+    BadTimestamp,
+    BadSymbol,
+    BadTradeId,
+    BadPrice,
+    BadVolume
+};
+
+const char* parse_status_message(ParseStatus status);
+
+// Legacy parser: throws std::runtime_error on malformed input
 TickerData parseTickerData(const std::string& csv_line);
 
+/**
+ * @brief Hot-path parser. Splits the line in place and converts with std::from_chars;
+ * never throws and does not allocate (known symbols resolve to their interned id).
+ * `out` is only fully written when Ok is returned.
+ */
+ParseStatus parseTickerData(std::string_view csv_line, TickerData& out);
+
 #endif // TICKER_DATA_H
\ No newline at end of file
@@ -0,0 +1,54 @@
+// File: /cpp_engine/include/UtcTime.h
+
+#ifndef UTC_TIME_H
+#define UTC_TIME_H
+
+#include <cstdio>
+#include <string>
+
+// Calendar helpers for file names keyed by UTC day (tick segments, DB partitions); no
+// time zone database or gmtime involved, so they are thread-safe and portable
+
+constexpr long long DAY_MS = 86400000;
+constexpr long long HOUR_MS = 3600000;
+
+// Start of the `interval_ms`-wide bucket holding `timestamp_ms`, also for negative timestamps
+inline long long floor_to_interval(long long timestamp_ms, long long interval_ms) {
+    long long rem = timestamp_ms % interval_ms;
+    return timestamp_ms - (rem < 0 ? rem + interval_ms : rem);
+}
+
+// "YYYY-MM-DD" of the UTC day holding `timestamp_ms` (civil-from-days, proleptic Gregorian)
+inline std::string utc_date(long long timestamp_ms) {
+    long long z = floor_to_interval(timestamp_ms, DAY_MS) / DAY_MS + 719468;
+    long long era = (z >= 0 ? z : z - 146096) / 146097;
+    unsigned doe = static_cast<unsigned>(z - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    unsigned d = doy - (153 * mp + 2) / 5 + 1;
+    unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    long long y = static_cast<long long>(yoe) + era * 400 + (m <= 2);
+    char name[32];
+    snprintf(name, sizeof(name), "%04lld-%02u-%02u", y, m, d);
+    return name;
+}
+
+// UTC midnight of a "YYYY-MM-DD" date (days-from-civil); false if `date` does not start with one
+inline bool parse_utc_date(const std::string& date, long long& day_start_ms) {
+    int y, m, d;
+    char tail;
+    if (date.size() < 10 || sscanf(date.c_str(), "%4d-%2d-%2d%c", &y, &m, &d, &tail) < 3 || m < 1 || m > 12 ||
+        d < 1 || d > 31) {
+        return false;
+    }
+    long long year = y - (m <= 2);
+    long long era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yoe = static_cast<unsigned>(year - era * 400);
+    unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    day_start_ms = (era * 146097 + static_cast<long long>(doe) - 719468) * DAY_MS;
+    return true;
+}
+
+#endif // UTC_TIME_H
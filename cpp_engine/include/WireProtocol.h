@@ -0,0 +1,77 @@
+// File: /cpp_engine/include/WireProtocol.h
+
+#ifndef WIRE_PROTOCOL_H
+#define WIRE_PROTOCOL_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "TickerData.h"
+
+/**
+ * Binary feed protocol (little-endian), negotiated by the first byte of a connection:
+ *
+ *   WIRE_HANDSHAKE_BINARY   -> binary frames follow
+ *   anything else           -> legacy CSV lines (the byte is the start of the first line)
+ *
+ * Frame:  [u32 payload_bytes][u8 type][u8 version][u16 count][payload]
+ *   FRAME_SYMBOL: count == 1, payload = u32 symbol_id, u8 name_len, name bytes
+ *   FRAME_TICKS:  payload = count x WireTick
+ *
+ * Symbol ids are chosen by the client and only meaningful on that connection; a
+ * FRAME_SYMBOL must precede the first tick that uses an id.
+ */
+constexpr uint8_t WIRE_HANDSHAKE_BINARY = 0xB1; // Never the first byte of a CSV line
+constexpr uint8_t WIRE_VERSION = 1;
+constexpr uint8_t FRAME_SYMBOL = 1;
+constexpr uint8_t FRAME_TICKS = 2;
+constexpr uint32_t WIRE_MAX_PAYLOAD = 16 * 1024; // Must fit in a connection LineBuffer
+
+#pragma pack(push, 1)
+struct WireFrameHeader {
+    uint32_t payload_bytes;
+    uint8_t type;
+    uint8_t version;
+    uint16_t count;
+};
+
+// One trade; open/high/low/close are all `price` on the trade stream
+struct WireTick {
+    uint32_t symbol_id;
+    uint32_t flags;      // Reserved, 0
+    int64_t timestamp_ms;
+    int64_t trade_id;
+    double price;
+    double quantity;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(WireFrameHeader) == 8, "WireFrameHeader must match the wire layout");
+static_assert(sizeof(WireTick) == 40, "WireTick must match the wire layout");
+
+enum class WireFormat {
+    Unknown,    // Handshake byte not received yet
+    Csv,
+    Binary
+};
+
+/**
+ * @brief Per-connection decoder for binary frames. Records are copied out with memcpy;
+ * the engine only targets little-endian hosts, matching the wire byte order.
+ */
+class BinaryFrameDecoder {
+private:
+    std::vector<std::string> symbols_;   // Client symbol id -> symbol name
+    std::vector<SymbolId> symbol_ids_;   // Client symbol id -> interned engine id
+
+public:
+    /**
+     * @brief Decodes every complete frame at the front of `bytes` into `out`.
+     * @param consumed Set to the number of bytes fully decoded (a partial frame is left).
+     * @return false on a protocol violation; the connection should be dropped.
+     */
+    bool decode(std::string_view bytes, std::vector<TickerData>& out, size_t& consumed);
+};
+
+#endif // WIRE_PROTOCOL_H
@@ -0,0 +1,125 @@
+// File: /cpp_engine/include/WorkStealingExecutor.h
+
+#ifndef WORK_STEALING_EXECUTOR_H
+#define WORK_STEALING_EXECUTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "CandleAggregator.h"
+#include "Constants.h"
+#include "Indicators.h"
+#include "PersistenceWriter.h"
+#include "SafeQueue.h"
+#include "TickProcessor.h"
+#include "TickSink.h"
+
+/**
+ * @brief Processing stage that balances uneven symbol load across a pool of workers.
+ *
+ * Every symbol is an actor: a mailbox of pending ticks plus its indicator and bar
+ * state. Ingest threads append to the mailbox and, if the actor is idle, queue it on
+ * the deque of the worker that last ran it. A worker runs an actor by taking its whole
+ * mailbox; when its own deque is empty it steals actors from the others. An actor is
+ * queued or running on at most one worker at a time, so each symbol's ticks are
+ * processed in order while hot symbols move to whichever workers are free.
+ *
+ * Each worker accumulates rows into its own WriteBatch and submits it to the shared
+ * PersistenceWriter every BATCH_SIZE rows, or FLUSH_TIMEOUT_MS after its first row.
+ */
+class WorkStealingExecutor : public TickSink {
+public:
+    // Cumulative counters for one worker
+    struct WorkerStats {
+        uint64_t ticks = 0;
+        uint64_t runs = 0;      // Actor runs (one mailbox each)
+        uint64_t steals = 0;    // Runs of actors taken from another worker's deque
+        uint64_t busy_ns = 0;   // Time spent running actors
+    };
+
+    // `indicators` must be configured; it and `writer` must outlive the executor
+    WorkStealingExecutor(PersistenceWriter& writer, const IndicatorRegistry& indicators,
+                         size_t workers = PROCESSING_WORKERS);
+    ~WorkStealingExecutor();
+
+    void start();
+
+    // Processes everything already delivered, submits the partial batches and the
+    // open bars, then joins the workers. Call after the ingestor has stopped.
+    void stop();
+
+    void push_bulk(std::vector<TickerData>& batch) override;
+
+    size_t worker_count() const { return workers_.size(); }
+    std::vector<WorkerStats> stats() const;
+
+    // Prints one "[EXECUTOR]" line with each worker's utilization since the last call
+    void log_stats();
+
+private:
+    struct SymbolActor {
+        std::mutex mutex;
+        std::vector<TickerData> inbox;      // Guarded by mutex
+        bool scheduled = false;             // Guarded by mutex; queued or running
+        std::atomic<size_t> home{0};        // Worker that last ran the actor
+
+        // Touched only by the worker running the actor
+        std::vector<TickerData> work;
+        IndicatorSet indicators;
+        SymbolBars bars;
+        size_t late_trades = 0;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<SymbolActor*> queue;     // Guarded by mutex; owner takes the front, thieves the back
+        std::thread thread;
+
+        // Owned by the worker thread
+        TickProcessor processor;
+        WriteBatch pending;
+        std::vector<Candle> stored_bars;    // Scratch for bars closed by TICK_ALREADY_STORED ticks
+        std::chrono::steady_clock::time_point pending_since;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> ticks{0};
+        std::atomic<uint64_t> runs{0};
+        std::atomic<uint64_t> steals{0};
+        std::atomic<uint64_t> busy_ns{0};
+
+        explicit Worker(const IndicatorRegistry& indicators) : processor(indicators) {}
+    };
+
+    PersistenceWriter& writer_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    // Dense symbol ids index the actor table directly; actors are created on first tick
+    std::unique_ptr<std::atomic<SymbolActor*>[]> actors_;
+    std::vector<std::unique_ptr<SymbolActor>> owned_actors_; // Guarded by create_mutex_
+    std::mutex create_mutex_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> queued_{0}; // Actors sitting in any deque
+    std::atomic<size_t> pending_ticks_{0};  // Ticks in mailboxes; bounded by QUEUE_CAPACITY
+    std::atomic<size_t> idle_workers_{0};
+    std::atomic<bool> running_{false};
+    std::mutex park_mutex_;
+    std::condition_variable work_available_;
+
+    std::vector<WorkerStats> last_stats_;   // Baseline for log_stats()
+    std::chrono::steady_clock::time_point last_stats_time_;
+
+    SymbolActor& actor_for(SymbolId id);
+    void schedule(SymbolActor& actor, size_t worker);
+    SymbolActor* take_local(Worker& worker);
+    SymbolActor* steal(size_t thief);
+    void run_actor(size_t index, SymbolActor& actor);
+    void flush_pending(Worker& worker);
+    void worker_loop(size_t index);
+};
+
+#endif // WORK_STEALING_EXECUTOR_H
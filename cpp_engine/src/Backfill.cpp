@@ -0,0 +1,86 @@
+#include "../include/Backfill.h"
+#include "../include/BatchIndicators.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+static const size_t RECOMPUTE_WRITE_CHUNK = 65536; // MetricRows materialized per insert call
+
+bool recompute_metrics(PersistenceBackend& db, const std::string& symbol) {
+    auto started = chrono::steady_clock::now();
+
+    TickColumns ticks;
+    if (!db.load_ticks(symbol, ticks)) return false;
+    if (ticks.size() == 0) {
+        cerr << "[RECOMPUTE] No trades stored for " << symbol << "." << endl;
+        return false;
+    }
+    auto loaded = chrono::steady_clock::now();
+
+    size_t n = ticks.size();
+    vector<double> vwap(n), sma_20(n), ema_20(n), ema_50(n);
+    BatchIndicators batch;
+    batch.session_vwap(ticks.timestamp_ms.data(), ticks.close.data(), ticks.volume.data(), n, vwap.data());
+    batch.sma(ticks.close.data(), n, 20, sma_20.data());
+    batch.ema(ticks.close.data(), n, 20, ema_20.data());
+    batch.ema(ticks.close.data(), n, 50, ema_50.data());
+    auto computed = chrono::steady_clock::now();
+
+    if (!db.begin_transaction()) return false;
+    SymbolId symbol_id = intern_symbol(symbol);
+    vector<MetricRow> rows;
+    rows.reserve(min(n, RECOMPUTE_WRITE_CHUNK));
+    for (size_t start = 0; start < n; start += RECOMPUTE_WRITE_CHUNK) {
+        size_t end = min(n, start + RECOMPUTE_WRITE_CHUNK);
+        rows.clear();
+        for (size_t i = start; i < end; ++i) {
+            rows.push_back(MetricRow{ticks.timestamp_ms[i], ticks.trade_id[i], symbol_id,
+                                     vwap[i], sma_20[i], ema_20[i], ema_50[i]});
+        }
+        if (!db.insert_metrics_batch(rows, true)) {
+            cerr << "[RECOMPUTE] Write failed. Rolling back." << endl;
+            db.rollback_transaction();
+            return false;
+        }
+    }
+    if (!db.commit_transaction()) {
+        db.rollback_transaction();
+        return false;
+    }
+    auto written = chrono::steady_clock::now();
+
+    auto ms = [](chrono::steady_clock::duration d) { return chrono::duration<double, milli>(d).count(); };
+    cout << "[RECOMPUTE] " << symbol << ": " << n << " trades (" << BatchIndicators::kernel_name(batch.kernel())
+         << " kernels) - load " << ms(loaded - started) << " ms, compute " << ms(computed - loaded)
+         << " ms, write " << ms(written - computed) << " ms." << endl;
+    return true;
+}
+
+bool replay_journal(const std::string& directory, uint64_t after, PersistenceBackend& lookup, TickSink& sink) {
+    auto started = chrono::steady_clock::now();
+
+    JournalScanStats stats;
+    size_t replayed = 0;
+    size_t stored = 0;
+    bool ok = scan_journal(directory, after, JOURNAL_REPLAY_BATCH, [&](vector<TickerData>& batch) {
+        if (!lookup.mark_stored(batch, stored)) return false;
+        replayed += batch.size();
+        sink.push_bulk(batch);
+        return true;
+    }, stats);
+    if (!ok) {
+        cerr << "[REPLAY] Journal replay from " << directory << " failed." << endl;
+        return false;
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    cout << "[REPLAY] " << directory << ": " << stats.records << " records in " << stats.segments << " segments"
+         << (stats.bad_segments ? " (" + to_string(stats.bad_segments) + " unreadable)" : string())
+         << ", " << replayed << " ticks after sequence " << after << " replayed (" << replayed - stored
+         << " missing from the DB) - "
+         << stats.bytes / (1024.0 * 1024.0) / max(seconds, 1e-9) << " MB/s." << endl;
+    return true;
+}
@@ -0,0 +1,286 @@
+#include "../include/BatchIndicators.h"
+#include "../include/CpuFeatures.h"
+#include <algorithm>
+#include <limits>
+
+#ifdef ENGINE_X86
+    #include <immintrin.h>
+#endif
+
+using namespace std;
+
+static const double NOT_READY = numeric_limits<double>::quiet_NaN();
+static const long long SESSION_LENGTH_MS = 24LL * 60 * 60 * 1000; // Matches SessionVwap
+static const size_t SCAN_CHUNK = 4096; // Scan block size; windowed sums also re-centre per block
+
+namespace {
+
+// --- Scan kernels: out[i] = initial + sum over j <= i of (x[j] - offset) * (y ? y[j] - offset : 1) ---
+
+void scan_scalar(const double* x, const double* y, size_t n, double offset, double initial, double* out) {
+    double sum = initial;
+    for (size_t i = 0; i < n; ++i) {
+        double term = x[i] - offset;
+        if (y) term *= y[i] - offset;
+        sum += term;
+        out[i] = sum;
+    }
+}
+
+void ema_scalar(const double* x, size_t n, double multiplier, double* out) {
+    double ema = x[0];
+    out[0] = ema;
+    for (size_t i = 1; i < n; ++i) {
+        ema = (x[i] * multiplier) + (ema * (1.0 - multiplier));
+        out[i] = ema;
+    }
+}
+
+#ifdef ENGINE_X86
+
+// [v0, v1, v2, v3] -> [0, v0, v1, v2]
+ENGINE_TARGET("avx2")
+inline __m256d shift_one(__m256d v) {
+    return _mm256_blend_pd(_mm256_permute4x64_pd(v, _MM_SHUFFLE(2, 1, 0, 0)), _mm256_setzero_pd(), 0x1);
+}
+
+// [v0, v1, v2, v3] -> [0, 0, v0, v1]
+ENGINE_TARGET("avx2")
+inline __m256d shift_two(__m256d v) {
+    return _mm256_permute2f128_pd(v, v, 0x08);
+}
+
+ENGINE_TARGET("avx2")
+void scan_avx2(const double* x, const double* y, size_t n, double offset, double initial, double* out) {
+    const __m256d off = _mm256_set1_pd(offset);
+    __m256d carry = _mm256_set1_pd(initial);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_sub_pd(_mm256_loadu_pd(x + i), off);
+        if (y) v = _mm256_mul_pd(v, _mm256_sub_pd(_mm256_loadu_pd(y + i), off));
+        v = _mm256_add_pd(v, shift_one(v));
+        v = _mm256_add_pd(v, shift_two(v));
+        v = _mm256_add_pd(v, carry);
+        _mm256_storeu_pd(out + i, v);
+        carry = _mm256_permute4x64_pd(v, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    double sum = _mm256_cvtsd_f64(carry);
+    for (; i < n; ++i) {
+        double term = x[i] - offset;
+        if (y) term *= y[i] - offset;
+        sum += term;
+        out[i] = sum;
+    }
+}
+
+/**
+ * y[i] = a * x[i] + b * y[i-1], four at a time. Within a block the local scan takes two
+ * shift-multiply-add steps; the previous block's last value then enters every lane
+ * scaled by b, b^2, b^3, b^4, so only that final add is on the serial path.
+ */
+ENGINE_TARGET("avx2")
+void ema_avx2(const double* x, size_t n, double multiplier, double* out) {
+    const double b = 1.0 - multiplier;
+    const __m256d a = _mm256_set1_pd(multiplier);
+    const __m256d b1 = _mm256_set1_pd(b);
+    const __m256d b2 = _mm256_set1_pd(b * b);
+    const __m256d powers = _mm256_set_pd(b * b * b * b, b * b * b, b * b, b);
+
+    out[0] = x[0];
+    __m256d carry = _mm256_set1_pd(x[0]);
+    size_t i = 1;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_mul_pd(a, _mm256_loadu_pd(x + i));
+        v = _mm256_add_pd(v, _mm256_mul_pd(b1, shift_one(v)));
+        v = _mm256_add_pd(v, _mm256_mul_pd(b2, shift_two(v)));
+        v = _mm256_add_pd(v, _mm256_mul_pd(powers, carry));
+        _mm256_storeu_pd(out + i, v);
+        carry = _mm256_permute4x64_pd(v, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    double ema = _mm256_cvtsd_f64(carry);
+    for (; i < n; ++i) {
+        ema = (x[i] * multiplier) + (ema * b);
+        out[i] = ema;
+    }
+}
+
+// out[i] = num[i] / den[i], or NaN where den[i] is not positive
+ENGINE_TARGET("avx2")
+void divide_avx2(const double* num, const double* den, size_t n, double* out) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d nan = _mm256_set1_pd(NOT_READY);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d d = _mm256_loadu_pd(den + i);
+        __m256d q = _mm256_div_pd(_mm256_loadu_pd(num + i), d);
+        _mm256_storeu_pd(out + i, _mm256_blendv_pd(nan, q, _mm256_cmp_pd(d, zero, _CMP_GT_OQ)));
+    }
+    for (; i < n; ++i) out[i] = den[i] > 0.0 ? num[i] / den[i] : NOT_READY;
+}
+
+/**
+ * Window statistics from centred prefix sums: for each r in [first, len), the window is
+ * (r - p, r], with prefix[-1] == 0 (only reached when first == p - 1).
+ */
+ENGINE_TARGET("avx2")
+void window_avx2(const double* prefix, const double* prefix_sq, size_t first, size_t len, size_t p,
+                 double offset, double* mean_out, double* variance_out) {
+    const __m256d inv_p = _mm256_set1_pd(1.0 / static_cast<double>(p));
+    const __m256d off = _mm256_set1_pd(offset);
+    const __m256d zero = _mm256_setzero_pd();
+    size_t r = first;
+
+    // The window that starts at the first sample has no prefix entry to subtract
+    if (r < p && r < len) {
+        double mean = prefix[r] / static_cast<double>(p);
+        mean_out[r] = offset + mean;
+        if (variance_out) variance_out[r] = max(0.0, prefix_sq[r] / static_cast<double>(p) - mean * mean);
+        ++r;
+    }
+    for (; r + 4 <= len; r += 4) {
+        __m256d mean = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(prefix + r), _mm256_loadu_pd(prefix + r - p)), inv_p);
+        _mm256_storeu_pd(mean_out + r, _mm256_add_pd(off, mean));
+        if (variance_out) {
+            __m256d sq = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(prefix_sq + r), _mm256_loadu_pd(prefix_sq + r - p)), inv_p);
+            _mm256_storeu_pd(variance_out + r, _mm256_max_pd(zero, _mm256_sub_pd(sq, _mm256_mul_pd(mean, mean))));
+        }
+    }
+    for (; r < len; ++r) {
+        double mean = (prefix[r] - prefix[r - p]) / static_cast<double>(p);
+        mean_out[r] = offset + mean;
+        if (variance_out) variance_out[r] = max(0.0, (prefix_sq[r] - prefix_sq[r - p]) / static_cast<double>(p) - mean * mean);
+    }
+}
+
+#endif // ENGINE_X86
+
+} // namespace
+
+// --- BatchIndicators ---
+
+BatchIndicators::BatchIndicators() : kernel_(Kernel::Scalar) {
+    if (cpu_features().avx2) kernel_ = Kernel::AVX2;
+}
+
+const char* BatchIndicators::kernel_name(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar: return "scalar";
+        case Kernel::AVX2:   return "avx2";
+    }
+    return "unknown";
+}
+
+void BatchIndicators::set_kernel(Kernel kernel) {
+    if (kernel == Kernel::AVX2 && !cpu_features().avx2) return;
+    kernel_ = kernel;
+}
+
+void BatchIndicators::scan(const double* x, const double* y, size_t n, double offset, double initial,
+                           double* out) const {
+#ifdef ENGINE_X86
+    if (kernel_ == Kernel::AVX2) {
+        scan_avx2(x, y, n, offset, initial, out);
+        return;
+    }
+#endif
+    scan_scalar(x, y, n, offset, initial, out);
+}
+
+void BatchIndicators::ema(const double* x, size_t n, int period, double* out) const {
+    if (n == 0) return;
+    double multiplier = 2.0 / (static_cast<double>(period) + 1.0);
+#ifdef ENGINE_X86
+    if (kernel_ == Kernel::AVX2) {
+        ema_avx2(x, n, multiplier, out);
+        return;
+    }
+#endif
+    ema_scalar(x, n, multiplier, out);
+}
+
+void BatchIndicators::sma(const double* x, size_t n, int period, double* out) const {
+    rolling_variance(x, n, period, out, nullptr);
+}
+
+void BatchIndicators::rolling_variance(const double* x, size_t n, int period, double* mean_out,
+                                       double* variance_out) const {
+    size_t p = static_cast<size_t>(max(1, period));
+    fill(mean_out, mean_out + min(n, p - 1), NOT_READY);
+    if (variance_out) fill(variance_out, variance_out + min(n, p - 1), NOT_READY);
+
+    // Each chunk scans its own window overlap, centred on its first sample, so prefix
+    // sums stay small however far the price drifts over the series; chunk-sized scratch
+    // also keeps the second pass in cache
+    for (size_t start = p - 1; start < n; start += SCAN_CHUNK) {
+        size_t lo = start - (p - 1);
+        size_t hi = min(n, start + SCAN_CHUNK);
+        size_t len = hi - lo;
+        double offset = x[lo];
+
+        prefix_.resize(len);
+        scan(x + lo, nullptr, len, offset, 0.0, prefix_.data());
+        if (variance_out) {
+            prefix_sq_.resize(len);
+            scan(x + lo, x + lo, len, offset, 0.0, prefix_sq_.data());
+        }
+
+    #ifdef ENGINE_X86
+        if (kernel_ == Kernel::AVX2) {
+            window_avx2(prefix_.data(), prefix_sq_.data(), start - lo, len, p, offset,
+                        mean_out + lo, variance_out ? variance_out + lo : nullptr);
+            continue;
+        }
+    #endif
+        const double inv_p = 1.0 / static_cast<double>(p);
+        for (size_t i = start; i < hi; ++i) {
+            size_t r = i - lo;
+            double sum = prefix_[r] - (r >= p ? prefix_[r - p] : 0.0);
+            double mean = sum * inv_p;
+            mean_out[i] = offset + mean;
+            if (variance_out) {
+                double sum_sq = prefix_sq_[r] - (r >= p ? prefix_sq_[r - p] : 0.0);
+                double variance = sum_sq * inv_p - mean * mean;
+                variance_out[i] = variance > 0.0 ? variance : 0.0;
+            }
+        }
+    }
+}
+
+void BatchIndicators::session_vwap(const long long* timestamp_ms, const double* price, const double* volume,
+                                   size_t n, double* out) const {
+    prefix_.resize(SCAN_CHUNK);
+    prefix_sq_.resize(SCAN_CHUNK);
+
+    // prefix_ = cumulative price * volume, prefix_sq_ = cumulative volume, both carried
+    // across chunks and reset at each session boundary
+    long long session = -1;
+    double price_volume = 0.0, total_volume = 0.0;
+    size_t start = 0;
+    while (start < n) {
+        long long chunk_session = timestamp_ms[start] - timestamp_ms[start] % SESSION_LENGTH_MS;
+        if (chunk_session > session) {
+            session = chunk_session;
+            price_volume = total_volume = 0.0;
+        }
+        size_t end = start + 1;
+        while (end < n && end - start < SCAN_CHUNK && timestamp_ms[end] - session < SESSION_LENGTH_MS) ++end;
+        size_t len = end - start;
+
+        scan(price + start, volume + start, len, 0.0, price_volume, prefix_.data());
+        scan(volume + start, nullptr, len, 0.0, total_volume, prefix_sq_.data());
+        price_volume = prefix_[len - 1];
+        total_volume = prefix_sq_[len - 1];
+
+    #ifdef ENGINE_X86
+        if (kernel_ == Kernel::AVX2) {
+            divide_avx2(prefix_.data(), prefix_sq_.data(), len, out + start);
+            start = end;
+            continue;
+        }
+    #endif
+        for (size_t i = 0; i < len; ++i) {
+            out[start + i] = prefix_sq_[i] > 0.0 ? prefix_[i] / prefix_sq_[i] : NOT_READY;
+        }
+        start = end;
+    }
+}
@@ -0,0 +1,64 @@
+#include "../include/CandleAggregator.h"
+#include <algorithm>
+
+using namespace std;
+
+static void start_bar(Candle& bar, const TickerData& trade, long long interval_ms, long long open_time_ms) {
+    bar.symbol_id = trade.symbol_id;
+    bar.trade_count = 1;
+    bar.interval_ms = interval_ms;
+    bar.open_time_ms = open_time_ms;
+    bar.open = bar.high = bar.low = bar.close = trade.close;
+    bar.volume = trade.volume;
+    bar.quote_volume = trade.close * trade.volume;
+}
+
+// --- SymbolBars ---
+
+bool SymbolBars::add(const TickerData& trade, std::vector<Candle>& closed) {
+    // Buckets nest (every interval divides the next), so a late trade is late for the
+    // finest interval first; check once so all intervals see the same set of trades
+    Candle& finest = bars_[0];
+    long long finest_open = trade.timestamp_ms - trade.timestamp_ms % BAR_INTERVALS_MS[0];
+    if (finest.trade_count > 0 && finest_open < finest.open_time_ms) {
+        return false;
+    }
+
+    for (size_t i = 0; i < BAR_INTERVAL_COUNT; ++i) {
+        Candle& bar = bars_[i];
+        long long open_time_ms = trade.timestamp_ms - trade.timestamp_ms % BAR_INTERVALS_MS[i];
+
+        if (bar.trade_count == 0) {
+            start_bar(bar, trade, BAR_INTERVALS_MS[i], open_time_ms);
+        } else if (open_time_ms > bar.open_time_ms) {
+            closed.push_back(bar);
+            start_bar(bar, trade, BAR_INTERVALS_MS[i], open_time_ms);
+        } else {
+            bar.high = max(bar.high, trade.close);
+            bar.low = min(bar.low, trade.close);
+            bar.close = trade.close;
+            bar.volume += trade.volume;
+            bar.quote_volume += trade.close * trade.volume;
+            ++bar.trade_count;
+        }
+    }
+    return true;
+}
+
+void SymbolBars::flush(std::vector<Candle>& out) {
+    for (Candle& bar : bars_) {
+        if (bar.trade_count == 0) continue;
+        out.push_back(bar);
+        bar.trade_count = 0;
+    }
+}
+
+// --- CandleAggregator ---
+
+void CandleAggregator::add(const TickerData& trade, std::vector<Candle>& closed) {
+    if (!open_bars_[trade.symbol_id].add(trade, closed)) ++late_trades_;
+}
+
+void CandleAggregator::flush(std::vector<Candle>& out) {
+    open_bars_.for_each([&out](SymbolId, SymbolBars& bars) { bars.flush(out); });
+}
@@ -0,0 +1,583 @@
+#include "../include/ColumnarTickStore.h"
+#include "../include/MappedFile.h"
+#include "../include/TickCodec.h"
+#include "../include/UtcTime.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <numeric>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const uint32_t TICK_SEGMENT_VERSION = 1;
+static const size_t MAX_GROW_BLOCKS = 64; // Mapping grows by doubling, at most 8 MB at a time
+
+namespace {
+
+size_t block_count(uint64_t rows) {
+    return static_cast<size_t>((rows + TICK_BLOCK_ROWS - 1) / TICK_BLOCK_ROWS);
+}
+
+// Column c of block b, relative to the start of the segment's data
+size_t column_offset(size_t block, size_t column) {
+    return TICK_SEGMENT_DATA_OFFSET + block * TICK_BLOCK_BYTES + column * TICK_BLOCK_ROWS * sizeof(double);
+}
+
+bool valid_header(const TickSegmentHeader& header) {
+    return memcmp(header.magic, TICK_SEGMENT_MAGIC, sizeof(header.magic)) == 0 &&
+           header.version == TICK_SEGMENT_VERSION && header.block_rows == TICK_BLOCK_ROWS;
+}
+
+} // namespace
+
+// --- Segment ---
+
+struct ColumnarTickStore::Segment {
+    MappedFile file;
+    SymbolId symbol = INVALID_SYMBOL;
+    long long day_start_ms = 0;
+    size_t committed = 0;   // Rows published in the header
+    size_t rows = 0;        // Committed rows plus those appended in this transaction
+    size_t blocks = 0;      // Blocks the mapping has room for
+    bool touched = false;
+
+    TickSegmentHeader& header() { return *reinterpret_cast<TickSegmentHeader*>(file.data()); }
+
+    template <typename T>
+    T* column(size_t block, size_t column) {
+        return reinterpret_cast<T*>(file.data() + column_offset(block, column));
+    }
+
+    bool map(const string& path, size_t blocks_needed) {
+        if (!file.open(path, MappedFile::Mode::ReadWrite, TICK_SEGMENT_DATA_OFFSET + blocks_needed * TICK_BLOCK_BYTES)) {
+            return false;
+        }
+        blocks = (file.size() - TICK_SEGMENT_DATA_OFFSET) / TICK_BLOCK_BYTES;
+        return true;
+    }
+
+    bool append(const TickerData& tick) {
+        if (rows == blocks * TICK_BLOCK_ROWS) {
+            string path = file.path();
+            if (!map(path, blocks + min(max<size_t>(blocks, 1), MAX_GROW_BLOCKS))) return false;
+        }
+        size_t block = rows / TICK_BLOCK_ROWS, i = rows % TICK_BLOCK_ROWS;
+        column<long long>(block, 0)[i] = tick.timestamp_ms;
+        column<long long>(block, 1)[i] = tick.trade_id;
+        column<double>(block, 2)[i] = tick.close;
+        column<double>(block, 3)[i] = tick.volume;
+        ++rows;
+        return true;
+    }
+
+    bool sync() {
+        return file.sync(0, TICK_SEGMENT_DATA_OFFSET + block_count(committed) * TICK_BLOCK_BYTES);
+    }
+
+    // Writes the block index after the last block, syncs and trims the file to its end
+    bool seal() {
+        string path = file.path();
+        size_t blocks_used = block_count(committed);
+        if (blocks_used == 0) {
+            file.close();
+            error_code ec;
+            fs::remove(path, ec);
+            return true;
+        }
+
+        vector<TickBlockIndex> index(blocks_used);
+        for (size_t b = 0; b < blocks_used; ++b) {
+            const long long* timestamps = column<long long>(b, 0);
+            size_t n = min(TICK_BLOCK_ROWS, committed - b * TICK_BLOCK_ROWS);
+            auto range = minmax_element(timestamps, timestamps + n);
+            index[b] = TickBlockIndex{*range.first, *range.second, n};
+        }
+
+        size_t footer = TICK_SEGMENT_DATA_OFFSET + blocks_used * TICK_BLOCK_BYTES;
+        size_t end = footer + index.size() * sizeof(TickBlockIndex);
+        if (end > file.size() && !file.open(path, MappedFile::Mode::ReadWrite, end)) return false;
+        memcpy(file.data() + footer, index.data(), index.size() * sizeof(TickBlockIndex));
+        header().footer_offset = footer;
+        bool synced = file.sync(0, end);
+        file.close();
+
+        error_code ec;
+        fs::resize_file(path, end, ec);
+        return synced && !ec;
+    }
+};
+
+// --- ColumnarTickStore ---
+
+ColumnarTickStore::ColumnarTickStore(PersistenceBackend& db, const std::string& directory)
+    : db_(db), directory_(directory), last_sync_(chrono::steady_clock::now()) {}
+
+ColumnarTickStore::~ColumnarTickStore() {
+    close();
+}
+
+bool ColumnarTickStore::open() {
+    error_code ec;
+    fs::create_directories(directory_, ec);
+    if (ec) {
+        cerr << "FATAL: Could not create tick store directory " << directory_ << ": " << ec.message() << endl;
+        return false;
+    }
+
+    // Segments left open by a crash: index them and drop their uncommitted tail
+    size_t recovered = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(directory_, ec)) {
+        if (entry.path().extension() != ".seg") continue;
+        TickSegmentHeader header{};
+        {
+            MappedFile file;
+            if (!file.open(entry.path().string(), MappedFile::Mode::ReadOnly) || file.size() < sizeof(header)) continue;
+            memcpy(&header, file.data(), sizeof(header));
+        }
+        if (!valid_header(header) || header.footer_offset != 0) continue;
+
+        Segment segment;
+        if (!segment.map(entry.path().string(), 1)) continue;
+        segment.committed = segment.rows = static_cast<size_t>(header.row_count);
+        if (block_count(segment.committed) <= segment.blocks && segment.seal()) ++recovered;
+    }
+    if (recovered > 0) cout << "[TICK STORE] Sealed " << recovered << " segments left open by an unclean shutdown." << endl;
+
+    cout << "[TICK STORE] Writing raw trades to columnar segments in " << directory_ << "." << endl;
+    return true;
+}
+
+void ColumnarTickStore::close() {
+    for (Segment* segment : touched_) segment->rows = segment->committed;
+    touched_.clear();
+
+    size_t sealed = 0;
+    segments_.for_each([&](SymbolId, vector<unique_ptr<Segment>>& open) {
+        for (auto& segment : open) {
+            if (!segment->seal()) cerr << "[TICK STORE] Could not seal " << segment->file.path() << "." << endl;
+            ++sealed;
+        }
+        open.clear();
+    });
+    if (sealed > 0) cout << "[TICK STORE] Sealed " << sealed << " segments." << endl;
+}
+
+ColumnarTickStore::Segment* ColumnarTickStore::segment_for(const TickerData& tick) {
+    long long day = floor_to_interval(tick.timestamp_ms, DAY_MS);
+    vector<unique_ptr<Segment>>& open = segments_[tick.symbol_id];
+    for (auto& segment : open) {
+        if (segment->day_start_ms == day) return segment.get();
+    }
+
+    fs::path dir = fs::path(directory_) / string(tick.symbol());
+    error_code ec;
+    fs::create_directories(dir, ec);
+    string path = (dir / (utc_date(day) + ".seg")).string();
+
+    auto segment = make_unique<Segment>();
+    if (!segment->map(path, 1)) return nullptr;
+    TickSegmentHeader& header = segment->header();
+    if (valid_header(header)) {
+        // Appending to an existing day (restart, or a late trade): unseal it
+        segment->committed = segment->rows = static_cast<size_t>(header.row_count);
+        header.footer_offset = 0;
+        if (block_count(segment->rows) > segment->blocks) {
+            cerr << "[TICK STORE] " << path << " is shorter than its row count." << endl;
+            return nullptr;
+        }
+    } else if (header.magic[0] == 0) {
+        memcpy(header.magic, TICK_SEGMENT_MAGIC, sizeof(header.magic));
+        header.version = TICK_SEGMENT_VERSION;
+        header.block_rows = TICK_BLOCK_ROWS;
+        header.day_start_ms = day;
+        header.row_count = 0;
+        header.footer_offset = 0;
+    } else {
+        cerr << "[TICK STORE] " << path << " is not a tick segment." << endl;
+        return nullptr;
+    }
+    segment->symbol = tick.symbol_id;
+    segment->day_start_ms = day;
+    open.push_back(std::move(segment));
+    return open.back().get();
+}
+
+// Once a symbol has trades from a later day, its older segments are complete
+void ColumnarTickStore::seal_stale_segments(SymbolId symbol) {
+    vector<unique_ptr<Segment>>& open = segments_[symbol];
+    if (open.size() < 2) return;
+    long long newest = 0;
+    for (auto& segment : open) newest = max(newest, segment->day_start_ms);
+    for (auto it = open.begin(); it != open.end();) {
+        if ((*it)->day_start_ms < newest) {
+            if (!(*it)->seal()) cerr << "[TICK STORE] Could not seal " << (*it)->file.path() << "." << endl;
+            it = open.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ColumnarTickStore::sync_all() {
+    segments_.for_each([](SymbolId, vector<unique_ptr<Segment>>& open) {
+        for (auto& segment : open) {
+            if (!segment->sync()) cerr << "[TICK STORE] Sync failed for " << segment->file.path() << "." << endl;
+        }
+    });
+    last_sync_ = chrono::steady_clock::now();
+}
+
+// --- Writes ---
+
+bool ColumnarTickStore::insert_raw_batch(const std::vector<TickerData>& rows) {
+    for (const TickerData& tick : rows) {
+        Segment* segment = segment_for(tick);
+        if (!segment || !segment->append(tick)) {
+            cerr << "[TICK STORE] Append failed for " << tick.symbol() << "." << endl;
+            return false;
+        }
+        if (!segment->touched) {
+            segment->touched = true;
+            touched_.push_back(segment);
+        }
+    }
+    return true;
+}
+
+bool ColumnarTickStore::insert_metrics_batch(const std::vector<MetricRow>& rows, bool replace) {
+    return db_.insert_metrics_batch(rows, replace);
+}
+
+bool ColumnarTickStore::insert_bars_batch(const std::vector<Candle>& bars) {
+    return db_.insert_bars_batch(bars);
+}
+
+bool ColumnarTickStore::insert_indicator_batch(const std::vector<IndicatorValue>& values) {
+    return db_.insert_indicator_batch(values);
+}
+
+bool ColumnarTickStore::begin_transaction() {
+    return db_.begin_transaction();
+}
+
+bool ColumnarTickStore::commit_transaction() {
+    // Trades are published before the SQLite commit: a crash in between leaves trades
+    // without metrics (journal replay writes them again), never metrics without trades
+    vector<SymbolId> symbols;
+    for (Segment* segment : touched_) {
+        segment->header().row_count = segment->rows;
+        segment->committed = segment->rows;
+        segment->touched = false;
+        symbols.push_back(segment->symbol);
+    }
+    touched_.clear();
+    if (chrono::steady_clock::now() - last_sync_ >= chrono::milliseconds(TICK_STORE_SYNC_INTERVAL_MS)) {
+        sync_all();
+    }
+    for (SymbolId symbol : symbols) seal_stale_segments(symbol);
+
+    return db_.commit_transaction();
+}
+
+bool ColumnarTickStore::rollback_transaction() {
+    for (Segment* segment : touched_) {
+        segment->rows = segment->committed;
+        segment->touched = false;
+    }
+    touched_.clear();
+    return db_.rollback_transaction();
+}
+
+// --- Reads ---
+
+namespace {
+
+// Reusable decode targets for one compressed block
+struct BlockScratch {
+    vector<long long> timestamp_ms, trade_id;
+    vector<double> price, qty;
+};
+
+bool overlaps(long long lo, long long hi, long long from_ms, long long to_ms) {
+    return hi >= from_ms && lo <= to_ms;
+}
+
+bool scan_plain(const MappedFile& file, const TickSegmentHeader& header, long long from_ms, long long to_ms,
+                unsigned columns, const std::function<void(const TickBlockView&)>& fn) {
+    size_t rows = static_cast<size_t>(header.row_count);
+    size_t blocks = block_count(rows);
+    if (file.size() < TICK_SEGMENT_DATA_OFFSET + blocks * TICK_BLOCK_BYTES) {
+        cerr << "[TICK STORE] " << file.path() << " is shorter than its row count." << endl;
+        return false;
+    }
+    const TickBlockIndex* index = nullptr;
+    if (header.footer_offset != 0 && header.footer_offset + blocks * sizeof(TickBlockIndex) <= file.size()) {
+        index = reinterpret_cast<const TickBlockIndex*>(file.data() + header.footer_offset);
+    }
+    bool whole_day = from_ms <= header.day_start_ms && to_ms >= header.day_start_ms + DAY_MS - 1;
+
+    for (size_t b = 0; b < blocks; ++b) {
+        size_t n = min(TICK_BLOCK_ROWS, rows - b * TICK_BLOCK_ROWS);
+        auto column = [&](size_t c) { return file.data() + column_offset(b, c); };
+        const long long* timestamps = reinterpret_cast<const long long*>(column(0));
+        if (!whole_day) {
+            if (index) {
+                if (!overlaps(index[b].min_timestamp_ms, index[b].max_timestamp_ms, from_ms, to_ms)) continue;
+            } else {
+                auto range = minmax_element(timestamps, timestamps + n);
+                if (!overlaps(*range.first, *range.second, from_ms, to_ms)) continue;
+            }
+        }
+
+        TickBlockView view{};
+        view.rows = n;
+        if (columns & TICK_COLUMN_TIMESTAMP) view.timestamp_ms = timestamps;
+        if (columns & TICK_COLUMN_TRADE_ID) view.trade_id = reinterpret_cast<const long long*>(column(1));
+        if (columns & TICK_COLUMN_PRICE) view.price = reinterpret_cast<const double*>(column(2));
+        if (columns & TICK_COLUMN_QTY) view.qty = reinterpret_cast<const double*>(column(3));
+        fn(view);
+    }
+    return true;
+}
+
+bool scan_compressed(const MappedFile& file, const TickSegmentHeader& header, long long from_ms, long long to_ms,
+                     unsigned columns, BlockScratch& scratch, const std::function<void(const TickBlockView&)>& fn) {
+    size_t blocks = block_count(header.row_count);
+    if (header.footer_offset + blocks * sizeof(TickCompressedBlockIndex) > file.size()) {
+        cerr << "[TICK STORE] " << file.path() << " has a truncated block index." << endl;
+        return false;
+    }
+    const TickCompressedBlockIndex* index =
+        reinterpret_cast<const TickCompressedBlockIndex*>(file.data() + header.footer_offset);
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(file.data());
+
+    for (size_t b = 0; b < blocks; ++b) {
+        const TickCompressedBlockIndex& entry = index[b];
+        if (!overlaps(entry.min_timestamp_ms, entry.max_timestamp_ms, from_ms, to_ms)) continue;
+        size_t n = static_cast<size_t>(entry.rows);
+        if (n > TICK_BLOCK_ROWS || entry.end_offset + 8 > header.footer_offset) {
+            cerr << "[TICK STORE] " << file.path() << " has a corrupt block index." << endl;
+            return false;
+        }
+
+        TickBlockView view{};
+        view.rows = n;
+        void* targets[4] = {scratch.timestamp_ms.data(), scratch.trade_id.data(), scratch.price.data(), scratch.qty.data()};
+        for (size_t c = 0; c < 4; ++c) {
+            if (!(columns & (1u << c))) continue;
+            if (decode_column(base + entry.column_offset[c], n, targets[c]) == 0) {
+                cerr << "[TICK STORE] " << file.path() << ": unknown column codec." << endl;
+                return false;
+            }
+        }
+        if (columns & TICK_COLUMN_TIMESTAMP) view.timestamp_ms = scratch.timestamp_ms.data();
+        if (columns & TICK_COLUMN_TRADE_ID) view.trade_id = scratch.trade_id.data();
+        if (columns & TICK_COLUMN_PRICE) view.price = scratch.price.data();
+        if (columns & TICK_COLUMN_QTY) view.qty = scratch.qty.data();
+        fn(view);
+    }
+    return true;
+}
+
+bool valid_compressed_header(const TickSegmentHeader& header) {
+    return memcmp(header.magic, TICK_SEGMENT_COMPRESSED_MAGIC, sizeof(header.magic)) == 0 &&
+           header.version == TICK_SEGMENT_VERSION && header.block_rows == TICK_BLOCK_ROWS;
+}
+
+bool is_segment_file(const fs::path& path) {
+    return path.extension() == ".seg" || path.extension() == ".segz";
+}
+
+} // namespace
+
+bool ColumnarTickStore::scan(const std::string& symbol, long long from_ms, long long to_ms, unsigned columns,
+                             const std::function<void(const TickBlockView&)>& fn) const {
+    fs::path dir = fs::path(directory_) / symbol;
+    error_code ec;
+    if (!fs::is_directory(dir, ec)) return true; // No trades for this symbol
+
+    vector<string> paths;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        if (is_segment_file(entry.path())) paths.push_back(entry.path().string());
+    }
+    sort(paths.begin(), paths.end()); // ISO dates sort chronologically
+
+    BlockScratch scratch;
+    for (const string& path : paths) {
+        MappedFile file;
+        if (!file.open(path, MappedFile::Mode::ReadOnly)) return false;
+        TickSegmentHeader header;
+        if (file.size() < sizeof(header)) continue; // Created but never written
+        memcpy(&header, file.data(), sizeof(header));
+        bool compressed = valid_compressed_header(header);
+        if (!compressed && !valid_header(header)) {
+            cerr << "[TICK STORE] " << path << " is not a tick segment." << endl;
+            return false;
+        }
+        if (header.day_start_ms > to_ms || header.day_start_ms + DAY_MS <= from_ms) continue;
+
+        if (compressed && scratch.qty.empty()) {
+            scratch.timestamp_ms.resize(TICK_BLOCK_ROWS);
+            scratch.trade_id.resize(TICK_BLOCK_ROWS);
+            scratch.price.resize(TICK_BLOCK_ROWS);
+            scratch.qty.resize(TICK_BLOCK_ROWS);
+        }
+        bool ok = compressed ? scan_compressed(file, header, from_ms, to_ms, columns, scratch, fn)
+                             : scan_plain(file, header, from_ms, to_ms, columns, fn);
+        if (!ok) return false;
+    }
+    return true;
+}
+
+bool ColumnarTickStore::load_ticks(const std::string& symbol, TickColumns& out) {
+    out.clear();
+    bool ok = scan(symbol, LLONG_MIN, LLONG_MAX, TICK_COLUMN_ALL, [&out](const TickBlockView& block) {
+        out.timestamp_ms.insert(out.timestamp_ms.end(), block.timestamp_ms, block.timestamp_ms + block.rows);
+        out.trade_id.insert(out.trade_id.end(), block.trade_id, block.trade_id + block.rows);
+        out.close.insert(out.close.end(), block.price, block.price + block.rows);
+        out.volume.insert(out.volume.end(), block.qty, block.qty + block.rows);
+    });
+    if (!ok) return false;
+
+    // Segments hold trades in arrival order; recompute expects (open_time_ms, trade_id)
+    size_t n = out.size();
+    auto before = [&out](size_t a, size_t b) {
+        return out.timestamp_ms[a] != out.timestamp_ms[b] ? out.timestamp_ms[a] < out.timestamp_ms[b]
+                                                          : out.trade_id[a] < out.trade_id[b];
+    };
+    bool sorted = true;
+    for (size_t i = 1; i < n && sorted; ++i) sorted = !before(i, i - 1);
+    if (sorted) return true;
+
+    vector<size_t> order(n);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), before);
+    TickColumns sorted_columns;
+    for (size_t i : order) {
+        sorted_columns.timestamp_ms.push_back(out.timestamp_ms[i]);
+        sorted_columns.trade_id.push_back(out.trade_id[i]);
+        sorted_columns.close.push_back(out.close[i]);
+        sorted_columns.volume.push_back(out.volume[i]);
+    }
+    out = std::move(sorted_columns);
+    return true;
+}
+
+// The metrics row of a trade is the marker, and it lives in the SQL store
+bool ColumnarTickStore::mark_stored(std::vector<TickerData>& ticks, size_t& stored) {
+    return db_.mark_stored(ticks, stored);
+}
+
+// --- Compression ---
+
+bool compress_tick_segments(const std::string& directory, long long before_ms, bool fixed_point,
+                            TickCompressionStats& stats) {
+    error_code ec;
+    if (!fs::is_directory(directory, ec)) {
+        cerr << "Error: tick store directory " << directory << " not found." << endl;
+        return false;
+    }
+    vector<fs::path> plain;
+    for (const auto& entry : fs::recursive_directory_iterator(directory, ec)) {
+        if (entry.path().extension() == ".seg") plain.push_back(entry.path());
+    }
+    sort(plain.begin(), plain.end());
+
+    vector<uint8_t> out;
+    for (const fs::path& path : plain) {
+        TickSegmentHeader header;
+        {
+            MappedFile file;
+            if (!file.open(path.string(), MappedFile::Mode::ReadOnly) || file.size() < sizeof(header)) continue;
+            memcpy(&header, file.data(), sizeof(header));
+            // Only sealed segments of finished days are cold
+            if (!valid_header(header) || header.footer_offset == 0 || header.day_start_ms + DAY_MS > before_ms) continue;
+
+            size_t rows = static_cast<size_t>(header.row_count);
+            size_t blocks = block_count(rows);
+            if (file.size() < TICK_SEGMENT_DATA_OFFSET + blocks * TICK_BLOCK_BYTES) {
+                cerr << "[COMPRESS] " << path.string() << " is shorter than its row count, skipped." << endl;
+                continue;
+            }
+
+            out.assign(sizeof(TickSegmentHeader), 0);
+            vector<TickCompressedBlockIndex> index(blocks);
+            for (size_t b = 0; b < blocks; ++b) {
+                size_t n = min(TICK_BLOCK_ROWS, rows - b * TICK_BLOCK_ROWS);
+                auto column = [&](size_t c) { return file.data() + column_offset(b, c); };
+                const long long* timestamps = reinterpret_cast<const long long*>(column(0));
+                auto range = minmax_element(timestamps, timestamps + n);
+                TickCompressedBlockIndex& entry = index[b];
+                entry.min_timestamp_ms = *range.first;
+                entry.max_timestamp_ms = *range.second;
+                entry.rows = n;
+
+                size_t before = out.size();
+                entry.column_offset[0] = out.size();
+                encode_delta_delta(timestamps, n, out);
+                stats.column_bytes[0] += out.size() - before;
+
+                before = out.size();
+                entry.column_offset[1] = out.size();
+                encode_delta_delta(reinterpret_cast<const long long*>(column(1)), n, out);
+                stats.column_bytes[1] += out.size() - before;
+
+                // Exchange prices and quantities are decimals with a fixed step
+                for (size_t c = 2; c < 4; ++c) {
+                    const double* values = reinterpret_cast<const double*>(column(c));
+                    before = out.size();
+                    entry.column_offset[c] = out.size();
+                    if (fixed_point && encode_fixed_point(values, n, TICK_MAX_DECIMALS, out)) {
+                        ++stats.fixed_point_blocks;
+                    } else {
+                        encode_xor(values, n, out);
+                    }
+                    stats.column_bytes[c] += out.size() - before;
+                }
+                entry.end_offset = out.size();
+            }
+            out.resize(out.size() + 8, 0); // Decoders read whole words past a column's end
+
+            TickSegmentHeader packed = header;
+            memcpy(packed.magic, TICK_SEGMENT_COMPRESSED_MAGIC, sizeof(packed.magic));
+            packed.footer_offset = out.size();
+            memcpy(out.data(), &packed, sizeof(packed));
+            const uint8_t* index_bytes = reinterpret_cast<const uint8_t*>(index.data());
+            out.insert(out.end(), index_bytes, index_bytes + index.size() * sizeof(TickCompressedBlockIndex));
+
+            stats.blocks += blocks;
+            stats.rows += rows;
+            stats.raw_bytes += rows * 4 * sizeof(double);
+        }
+
+        // A late trade can reopen a day that was already compressed; keep both files
+        fs::path target = path;
+        target.replace_extension(".segz");
+        for (int n = 1; fs::exists(target, ec); ++n) {
+            target = path;
+            target.replace_extension("." + to_string(n) + ".segz");
+        }
+        fs::path temporary = target;
+        temporary += ".tmp";
+        {
+            MappedFile file;
+            if (!file.open(temporary.string(), MappedFile::Mode::ReadWrite, out.size())) return false;
+            memcpy(file.data(), out.data(), out.size());
+            if (!file.sync(0, out.size())) {
+                cerr << "[COMPRESS] Sync failed for " << temporary.string() << "." << endl;
+                return false;
+            }
+        }
+        fs::rename(temporary, target, ec);
+        if (ec || !fs::remove(path, ec)) {
+            cerr << "[COMPRESS] Could not replace " << path.string() << ": " << ec.message() << endl;
+            return false;
+        }
+        ++stats.segments;
+    }
+    return true;
+}
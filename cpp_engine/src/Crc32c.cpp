@@ -0,0 +1,54 @@
+#include "../include/Crc32c.h"
+#include "../include/CpuFeatures.h"
+#include <cstring>
+
+#ifdef ENGINE_X86
+    #include <nmmintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+struct Crc32cTable {
+    uint32_t entries[256];
+    Crc32cTable() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+            entries[i] = crc;
+        }
+    }
+};
+
+uint32_t crc32c_table(const unsigned char* p, size_t length, uint32_t crc) {
+    static const Crc32cTable table;
+    for (size_t i = 0; i < length; ++i) crc = table.entries[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+#if defined(ENGINE_X86) && (defined(__x86_64__) || defined(_M_X64))
+ENGINE_TARGET("sse4.2")
+uint32_t crc32c_sse42(const unsigned char* p, size_t length, uint32_t crc) {
+    uint64_t wide = crc;
+    for (; length >= 8; p += 8, length -= 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        wide = _mm_crc32_u64(wide, word);
+    }
+    crc = static_cast<uint32_t>(wide);
+    for (; length > 0; ++p, --length) crc = _mm_crc32_u8(crc, *p);
+    return crc;
+}
+#endif
+
+} // namespace
+
+uint32_t crc32c(const void* data, size_t length, uint32_t crc) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+#if defined(ENGINE_X86) && (defined(__x86_64__) || defined(_M_X64))
+    if (cpu_features().sse42) return ~crc32c_sse42(p, length, crc);
+#endif
+    return ~crc32c_table(p, length, crc);
+}
@@ -1,7 +1,6 @@
 #include "../include/DataIngestor.h"
 #include "../include/TickerData.h"
 #include "../include/Constants.h"
-#include <sstream>
 #include <string.h>
 #include <iostream>
 #include <vector>
@@ -12,13 +11,25 @@
 #else
     #include <sys/socket.h>
     #include <netinet/in.h>
+    #include <arpa/inet.h>
     #include <unistd.h>
+    #include <fcntl.h>
+    #include <errno.h>
+#endif
+
+#ifdef __linux__
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <unordered_map>
 #endif
 
 using namespace std;
 
-DataIngestor::DataIngestor(SafeQueue<TickerData>& queue)
-    : data_queue_(queue), server_socket_(-1), running_(false) {
+DataIngestor::DataIngestor(TickSink& sink, IngestMode mode)
+    : sink_(sink), mode_(mode), server_socket_(-1) {
+    #ifndef __linux__
+        mode_ = IngestMode::ThreadPerClient; // epoll is not available on this platform
+    #endif
     #ifdef _WIN32
         WSADATA wsaData;
         WSAStartup(MAKEWORD(2, 2), &wsaData);
@@ -62,6 +73,14 @@ void DataIngestor::start_server() {
         return;
     }
 
+    #ifdef __linux__
+        if (mode_ == IngestMode::EventLoop && !start_io_workers()) {
+            cerr << "FATAL: Could not start epoll I/O workers." << endl;
+            running_ = false;
+            return;
+        }
+    #endif
+
     cout << "TCP Server started on " << SERVER_IP << ":" << SERVER_PORT << ". Waiting for client..." << endl;
 
     while (running_) {
@@ -82,6 +101,15 @@ void DataIngestor::start_server() {
             continue;
         }
 
+        #ifdef __linux__
+            if (mode_ == IngestMode::EventLoop) {
+                if (!dispatch_to_worker(client_socket)) {
+                    close(client_socket);
+                }
+                continue;
+            }
+        #endif
+
         cout << "Client connected. Starting thread..." << endl;
         client_threads_.emplace_back(&DataIngestor::handle_client, this, client_socket);
     }
@@ -89,26 +117,19 @@ void DataIngestor::start_server() {
 
 // --- Client Handler (Receives and Processes Data) ---
 
+static void report_parse_error(string_view line, ParseStatus status) {
+    cerr << "Parsing error: " << parse_status_message(status) << " | Data: " << line << endl;
+}
+
 void DataIngestor::handle_client(int client_socket) {
-    char buffer[4096];
+    ClientConnection conn;
+    DecodeContext ctx;
+    ctx.decoder.set_error_handler(report_parse_error);
     int bytes_received;
 
-    while (running_ && (bytes_received = recv(client_socket, buffer, sizeof(buffer) - 1, 0)) > 0) {
-        buffer[bytes_received] = '\0'; 
-
-        stringstream ss(buffer);
-        string line;
-
-        while (getline(ss, line, '\n')) {
-            if (line.empty()) continue;
-
-            try {
-                TickerData data = parseTickerData(line);
-                data_queue_.push(data);
-            } catch (const exception& e) {
-                cerr << "Parsing error: " << e.what() << " | Data: " << line << endl;
-            }
-        }
+    while (running_ && (bytes_received = recv(client_socket, conn.buffer.write_ptr(), (int)conn.buffer.writable(), 0)) > 0) {
+        conn.buffer.commit(bytes_received);
+        if (!process_buffer(conn, ctx)) break;
     }
 
     #ifdef _WIN32
@@ -120,6 +141,175 @@ void DataIngestor::handle_client(int client_socket) {
     cout << "Client disconnected." << endl;
 }
 
+bool DataIngestor::process_buffer(ClientConnection& conn, DecodeContext& ctx) {
+    if (conn.format == WireFormat::Unknown) {
+        if (conn.buffer.buffered() == 0) return true;
+        if (static_cast<uint8_t>(conn.buffer.buffered_data()[0]) == WIRE_HANDSHAKE_BINARY) {
+            conn.format = WireFormat::Binary;
+            conn.buffer.consume(1);
+            cout << "Client negotiated binary wire format." << endl;
+        } else {
+            conn.format = WireFormat::Csv;
+        }
+    }
+
+    if (conn.format == WireFormat::Csv) {
+        drain_lines(conn.buffer, ctx);
+        return true;
+    }
+
+    size_t consumed = 0;
+    bool ok = conn.binary.decode(conn.buffer.buffered_data(), ctx.batch, consumed);
+    sink_.push_bulk(ctx.batch);
+    conn.buffer.consume(consumed);
+    return ok;
+}
+
+void DataIngestor::drain_lines(LineBuffer& buffer, DecodeContext& ctx) {
+    string_view lines = buffer.complete_lines();
+    ctx.decoder.decode(lines, ctx.batch);
+    sink_.push_bulk(ctx.batch);
+
+    size_t dropped_before = buffer.dropped_lines();
+    buffer.consume(lines.size());
+    if (buffer.dropped_lines() != dropped_before) {
+        cerr << "Parsing error: record exceeds " << LineBuffer::DEFAULT_CAPACITY << " bytes, discarded." << endl;
+    }
+}
+
+#ifdef __linux__
+
+// --- Event Loop (epoll) ---
+
+static bool set_non_blocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+bool DataIngestor::start_io_workers() {
+    for (int i = 0; i < IO_THREADS; ++i) {
+        auto worker = make_unique<IoWorker>();
+        worker->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        worker->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (worker->epoll_fd < 0 || worker->wake_fd < 0) {
+            if (worker->epoll_fd >= 0) close(worker->epoll_fd);
+            if (worker->wake_fd >= 0) close(worker->wake_fd);
+            stop_io_workers();
+            return false;
+        }
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = worker->wake_fd;
+        epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, worker->wake_fd, &ev);
+
+        io_workers_.push_back(std::move(worker));
+    }
+
+    for (auto& worker : io_workers_) {
+        worker->thread = std::thread(&DataIngestor::io_loop, this, std::ref(*worker));
+    }
+    cout << "Event loop ingestion started with " << io_workers_.size() << " I/O threads." << endl;
+    return true;
+}
+
+bool DataIngestor::dispatch_to_worker(int client_socket) {
+    if (!set_non_blocking(client_socket)) {
+        cerr << "Error: could not make client socket non-blocking." << endl;
+        return false;
+    }
+
+    // Round-robin assignment; the worker owns the socket from here on
+    IoWorker& worker = *io_workers_[next_worker_++ % io_workers_.size()];
+
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+    ev.data.fd = client_socket;
+    if (epoll_ctl(worker.epoll_fd, EPOLL_CTL_ADD, client_socket, &ev) < 0) {
+        cerr << "Error: epoll_ctl ADD failed for client socket." << endl;
+        return false;
+    }
+
+    cout << "Client connected. Assigned to I/O worker." << endl;
+    return true;
+}
+
+void DataIngestor::io_loop(IoWorker& worker) {
+    epoll_event events[EPOLL_MAX_EVENTS];
+    unordered_map<int, ClientConnection> connections; // Receive state per socket
+    DecodeContext ctx;
+    ctx.decoder.set_error_handler(report_parse_error);
+
+    auto close_connection = [&](int fd) {
+        epoll_ctl(worker.epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections.erase(fd);
+        cout << "Client disconnected." << endl;
+    };
+
+    while (running_) {
+        int n = epoll_wait(worker.epoll_fd, events, EPOLL_MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            cerr << "Error: epoll_wait failed." << endl;
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == worker.wake_fd) {
+                continue; // Shutdown wake-up; loop condition re-checks running_
+            }
+            ClientConnection& conn = connections.try_emplace(fd).first->second;
+
+            // Edge-triggered: drain the socket until the kernel reports EAGAIN
+            bool closed = false;
+            while (true) {
+                ssize_t bytes_received = recv(fd, conn.buffer.write_ptr(), conn.buffer.writable(), 0);
+                if (bytes_received > 0) {
+                    conn.buffer.commit(bytes_received);
+                    if (!process_buffer(conn, ctx)) {
+                        closed = true;
+                        break;
+                    }
+                    continue;
+                }
+                if (bytes_received < 0 && errno == EINTR) continue;
+                if (bytes_received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                closed = true; // 0 = orderly shutdown, otherwise a socket error
+                break;
+            }
+
+            if (closed || (events[i].events & (EPOLLERR | EPOLLHUP))) {
+                close_connection(fd);
+            }
+        }
+    }
+
+    for (auto& entry : connections) {
+        close(entry.first);
+    }
+}
+
+void DataIngestor::stop_io_workers() {
+    for (auto& worker : io_workers_) {
+        uint64_t one = 1;
+        if (worker->wake_fd >= 0 && write(worker->wake_fd, &one, sizeof(one)) < 0) {
+            cerr << "Warning: could not wake I/O worker." << endl;
+        }
+    }
+    for (auto& worker : io_workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+        close(worker->epoll_fd);
+        close(worker->wake_fd);
+    }
+    io_workers_.clear();
+}
+
+#endif // __linux__
+
 // --- Shutdown ---
 
 void DataIngestor::stop_server() {
@@ -131,10 +321,15 @@ void DataIngestor::stop_server() {
         #ifdef _WIN32
             closesocket(server_socket_);
         #else
+            shutdown(server_socket_, SHUT_RDWR); // Unblocks accept() on Linux
             close(server_socket_);
         #endif
     }
 
+    #ifdef __linux__
+        stop_io_workers();
+    #endif
+
     for (auto& t : client_threads_) {
         if (t.joinable()) {
             t.join();
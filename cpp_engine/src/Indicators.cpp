@@ -0,0 +1,348 @@
+#include "../include/Indicators.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+static const long long SESSION_LENGTH_MS = 24LL * 60 * 60 * 1000; // Sessions are UTC days
+
+// --- EMA banks ---
+
+RuntimeEmaBank::RuntimeEmaBank(const std::vector<int>& periods) : ema_(periods.size(), 0.0) {
+    for (int period : periods) {
+        multipliers_.push_back(2.0 / (static_cast<double>(period) + 1.0));
+        retention_.push_back(1.0 - multipliers_.back());
+    }
+}
+
+void RuntimeEmaBank::update(const TickerData& tick) {
+    double price = tick.close;
+    if (!seeded_) {
+        std::fill(ema_.begin(), ema_.end(), price);
+        seeded_ = true;
+        return;
+    }
+    for (size_t i = 0; i < ema_.size(); ++i) {
+        ema_[i] = (price * multipliers_[i]) + (ema_[i] * retention_[i]);
+    }
+}
+
+namespace {
+
+template <typename Bank>
+bool bank_matches(const std::vector<int>& periods) {
+    if (periods.size() != Bank::COUNT) return false;
+    for (size_t i = 0; i < Bank::COUNT; ++i) {
+        if (periods[i] != Bank::periods[i]) return false;
+    }
+    return true;
+}
+
+// Tries each preset in order; the first exact match is instantiated
+template <typename... Banks>
+std::unique_ptr<Indicator> make_preset_bank(const std::vector<int>& periods) {
+    std::unique_ptr<Indicator> bank;
+    ((bank == nullptr && bank_matches<Banks>(periods) ? (bank = std::make_unique<Banks>(), true) : false) || ...);
+    return bank;
+}
+
+} // namespace
+
+std::unique_ptr<Indicator> make_ema_bank(const std::vector<int>& periods) {
+    // Period sets worth a dedicated instantiation; anything else runs on RuntimeEmaBank
+    auto bank = make_preset_bank<EmaBank<20, 50>, EmaBank<20>, EmaBank<50>, EmaBank<12, 26>,
+                                 EmaBank<9, 21>, EmaBank<20, 50, 200>>(periods);
+    if (bank) return bank;
+    return std::make_unique<RuntimeEmaBank>(periods);
+}
+
+// --- Indicators ---
+
+void SessionVwap::update(const TickerData& tick) {
+    long long session_start = tick.timestamp_ms - tick.timestamp_ms % SESSION_LENGTH_MS;
+    if (session_start > session_start_ms_) {
+        session_start_ms_ = session_start;
+        price_volume_ = 0.0;
+        volume_ = 0.0;
+    }
+    price_volume_ += tick.close * tick.volume;
+    volume_ += tick.volume;
+}
+
+double SessionVwap::value(size_t) const {
+    return volume_ > 0.0 ? price_volume_ / volume_ : INDICATOR_WARMING_UP;
+}
+
+void RollingVwap::update(const TickerData& tick) {
+    if (count_ == entries_.size()) {
+        // Unroll into a ring twice the size; after the busiest window this never happens again
+        vector<Entry> grown(max<size_t>(16, 2 * entries_.size()));
+        for (size_t i = 0; i < count_; ++i) grown[i] = entries_[(head_ + i) % entries_.size()];
+        entries_.swap(grown);
+        head_ = 0;
+    }
+    double price_volume = tick.close * tick.volume;
+    entries_[(head_ + count_) % entries_.size()] = Entry{tick.timestamp_ms, price_volume, tick.volume};
+    ++count_;
+    price_volume_ += price_volume;
+    volume_ += tick.volume;
+
+    long long cutoff = tick.timestamp_ms - window_ms_;
+    while (count_ > 0 && entries_[head_].timestamp_ms <= cutoff) {
+        price_volume_ -= entries_[head_].price_volume;
+        volume_ -= entries_[head_].volume;
+        head_ = head_ + 1 == entries_.size() ? 0 : head_ + 1;
+        --count_;
+    }
+    if (count_ == 1) {
+        // Restart the sums from the single entry so subtraction error cannot accumulate
+        price_volume_ = entries_[head_].price_volume;
+        volume_ = entries_[head_].volume;
+    }
+}
+
+double RollingVwap::value(size_t) const {
+    return volume_ > 0.0 ? price_volume_ / volume_ : INDICATOR_WARMING_UP;
+}
+
+void Sma::update(const TickerData& tick) {
+    if (window_.full()) sum_ -= window_.oldest();
+    window_.push(tick.close);
+    sum_ += tick.close;
+    if (window_.wrapped()) sum_ = window_.sum(); // O(period) once every `period` ticks
+}
+
+double Sma::value(size_t) const {
+    return window_.full() ? sum_ / static_cast<double>(window_.capacity()) : INDICATOR_WARMING_UP;
+}
+
+void Rsi::update(const TickerData& tick) {
+    if (!has_price_) {
+        last_price_ = tick.close;
+        has_price_ = true;
+        return;
+    }
+    double change = tick.close - last_price_;
+    last_price_ = tick.close;
+    double gain = change > 0.0 ? change : 0.0;
+    double loss = change < 0.0 ? -change : 0.0;
+
+    if (changes_ < period_) {
+        // Seed with the simple average of the first `period` changes
+        ++changes_;
+        avg_gain_ += (gain - avg_gain_) / changes_;
+        avg_loss_ += (loss - avg_loss_) / changes_;
+    } else {
+        avg_gain_ = (avg_gain_ * (period_ - 1) + gain) / period_;
+        avg_loss_ = (avg_loss_ * (period_ - 1) + loss) / period_;
+    }
+}
+
+double Rsi::value(size_t) const {
+    if (changes_ < period_) return INDICATOR_WARMING_UP;
+    if (avg_loss_ == 0.0) return avg_gain_ == 0.0 ? 50.0 : 100.0;
+    return 100.0 - 100.0 / (1.0 + avg_gain_ / avg_loss_);
+}
+
+void Macd::update(const TickerData& tick) {
+    fast_.add(tick.close);
+    slow_.add(tick.close);
+    signal_.add(fast_.current() - slow_.current());
+}
+
+double Macd::value(size_t output) const {
+    if (!signal_.seeded()) return INDICATOR_WARMING_UP;
+    double macd = fast_.current() - slow_.current();
+    switch (output) {
+        case 0: return macd;
+        case 1: return signal_.current();
+        default: return macd - signal_.current();
+    }
+}
+
+void Bollinger::update(const TickerData& tick) {
+    double x = tick.close;
+    if (window_.full()) {
+        // Replace the oldest sample: Welford removal followed by insertion at fixed n
+        double old = window_.oldest();
+        double n = static_cast<double>(window_.size());
+        double old_mean = mean_;
+        mean_ += (x - old) / n;
+        m2_ += (x - old) * (x - mean_ + old - old_mean);
+    } else {
+        double n = static_cast<double>(window_.size() + 1);
+        double delta = x - mean_;
+        mean_ += delta / n;
+        m2_ += delta * (x - mean_);
+    }
+    if (m2_ < 0.0) m2_ = 0.0;
+    window_.push(x);
+}
+
+double Bollinger::value(size_t output) const {
+    if (!window_.full()) return INDICATOR_WARMING_UP;
+    double deviation = sqrt(m2_ / static_cast<double>(window_.capacity()));
+    switch (output) {
+        case 0: return mean_;
+        case 1: return mean_ + width_ * deviation;
+        default: return mean_ - width_ * deviation;
+    }
+}
+
+void Atr::update(const TickerData& tick) {
+    double range = tick.high - tick.low;
+    if (has_close_) {
+        range = max(tick.high, last_close_) - min(tick.low, last_close_);
+    }
+    last_close_ = tick.close;
+    has_close_ = true;
+
+    if (ranges_ < period_) {
+        ++ranges_;
+        atr_ += (range - atr_) / ranges_;
+    } else {
+        atr_ = (atr_ * (period_ - 1) + range) / period_;
+    }
+}
+
+double Atr::value(size_t) const {
+    return ranges_ >= period_ ? atr_ : INDICATOR_WARMING_UP;
+}
+
+// --- Registry ---
+
+IndicatorRegistry::IndicatorRegistry() {
+    auto period = [](double p) { return max(1, static_cast<int>(p)); };
+
+    register_kind("vwap", Kind{0, 1, {}, {"vwap"}, [](const vector<double>& p) -> unique_ptr<Indicator> {
+        if (p.empty()) return make_unique<SessionVwap>();
+        return make_unique<RollingVwap>(static_cast<long long>(p[0] * 1000.0)); // Window in seconds
+    }});
+    register_kind("sma", Kind{0, 1, {20}, {"sma"}, [period](const vector<double>& p) {
+        return make_unique<Sma>(period(p[0]));
+    }});
+    register_kind("ema", Kind{0, 16, {20}, {"ema"}, [period](const vector<double>& p) {
+        vector<int> periods;
+        for (double value : p) periods.push_back(period(value));
+        return make_ema_bank(periods);
+    }, true});
+    register_kind("rsi", Kind{0, 1, {14}, {"rsi"}, [period](const vector<double>& p) {
+        return make_unique<Rsi>(period(p[0]));
+    }});
+    register_kind("macd", Kind{0, 3, {12, 26, 9}, {"macd", "macd_signal", "macd_hist"}, [period](const vector<double>& p) {
+        return make_unique<Macd>(period(p[0]), period(p[1]), period(p[2]));
+    }});
+    register_kind("bb", Kind{0, 2, {20, 2}, {"bb_mid", "bb_upper", "bb_lower"}, [period](const vector<double>& p) {
+        return make_unique<Bollinger>(period(p[0]), p[1]);
+    }});
+    register_kind("atr", Kind{0, 1, {14}, {"atr"}, [period](const vector<double>& p) {
+        return make_unique<Atr>(period(p[0]));
+    }});
+}
+
+void IndicatorRegistry::register_kind(const std::string& name, Kind kind) {
+    size_t index = find_kind(name);
+    if (index != npos) {
+        kinds_[index].second = std::move(kind);
+    } else {
+        kinds_.emplace_back(name, std::move(kind));
+    }
+}
+
+size_t IndicatorRegistry::find_kind(std::string_view name) const {
+    for (size_t i = 0; i < kinds_.size(); ++i) {
+        if (kinds_[i].first == name) return i;
+    }
+    return npos;
+}
+
+bool IndicatorRegistry::configure(std::string_view spec, std::string& error) {
+    vector<Configured> configured;
+    vector<string> names;
+
+    while (!spec.empty()) {
+        size_t comma = spec.find(',');
+        string_view entry = spec.substr(0, comma);
+        spec = comma == string_view::npos ? string_view() : spec.substr(comma + 1);
+        if (entry.empty()) continue;
+
+        size_t colon = entry.find(':');
+        string_view kind_name = entry.substr(0, colon);
+        size_t kind_index = find_kind(kind_name);
+        if (kind_index == npos) {
+            error = "unknown indicator '" + string(kind_name) + "'";
+            return false;
+        }
+        const Kind& kind = kinds_[kind_index].second;
+
+        // Parameters keep their spelling for output names ("bb:20:2.5" -> "bb_upper_20_2.5")
+        vector<double> params;
+        vector<string> tokens;
+        while (colon != string_view::npos) {
+            entry.remove_prefix(colon + 1);
+            colon = entry.find(':');
+            string token(entry.substr(0, colon));
+            char* end = nullptr;
+            double value = strtod(token.c_str(), &end);
+            if (token.empty() || *end != '\0' || !(value > 0.0)) {
+                error = "bad parameter '" + token + "' for indicator '" + string(kind_name) + "'";
+                return false;
+            }
+            params.push_back(value);
+            tokens.push_back(std::move(token));
+        }
+        if (params.size() < kind.min_params || params.size() > kind.max_params) {
+            error = "wrong number of parameters for indicator '" + string(kind_name) + "'";
+            return false;
+        }
+        for (size_t i = params.size(); i < kind.defaults.size(); ++i) {
+            params.push_back(kind.defaults[i]);
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%g", kind.defaults[i]);
+            tokens.push_back(buffer);
+        }
+
+        vector<string> outputs;
+        if (kind.output_per_param) {
+            for (const string& token : tokens) outputs.push_back(kind.outputs[0] + "_" + token);
+        } else {
+            string suffix;
+            for (const string& token : tokens) suffix += "_" + token;
+            for (const string& output : kind.outputs) outputs.push_back(output + suffix);
+        }
+        for (string& name : outputs) {
+            if (find(names.begin(), names.end(), name) != names.end()) {
+                error = "indicator output '" + name + "' configured twice";
+                return false;
+            }
+            names.push_back(std::move(name));
+        }
+        configured.push_back(Configured{kind_index, std::move(params)});
+    }
+
+    if (configured.empty()) {
+        error = "no indicators configured";
+        return false;
+    }
+    configured_ = std::move(configured);
+    output_names_ = std::move(names);
+    return true;
+}
+
+size_t IndicatorRegistry::output_index(std::string_view name) const {
+    for (size_t i = 0; i < output_names_.size(); ++i) {
+        if (output_names_[i] == name) return i;
+    }
+    return npos;
+}
+
+IndicatorSet IndicatorRegistry::create_set() const {
+    IndicatorSet set;
+    set.reserve(configured_.size());
+    for (const Configured& entry : configured_) {
+        set.push_back(kinds_[entry.kind].second.make(entry.params));
+    }
+    return set;
+}
@@ -0,0 +1,150 @@
+#include "../include/MappedFile.h"
+#include <iostream>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace std;
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path, Mode mode, size_t size) {
+    close();
+    writable_ = mode == Mode::ReadWrite;
+
+    HANDLE file = CreateFileA(path.c_str(), writable_ ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, writable_ ? OPEN_ALWAYS : OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        cerr << "Error: could not open " << path << " (error " << GetLastError() << ")." << endl;
+        return false;
+    }
+
+    LARGE_INTEGER current;
+    GetFileSizeEx(file, &current);
+    size_t file_size = static_cast<size_t>(current.QuadPart);
+    if (writable_ && size > file_size) {
+        LARGE_INTEGER target;
+        target.QuadPart = static_cast<LONGLONG>(size);
+        if (!SetFilePointerEx(file, target, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+            cerr << "Error: could not size " << path << " (error " << GetLastError() << ")." << endl;
+            CloseHandle(file);
+            return false;
+        }
+        file_size = size;
+    }
+
+    file_ = file;
+    path_ = path;
+    size_ = file_size;
+    opened_ = true;
+    if (file_size == 0) return true; // Nothing to map
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, writable_ ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, writable_ ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        cerr << "Error: could not map " << path << " (error " << GetLastError() << ")." << endl;
+        if (mapping) CloseHandle(mapping);
+        close();
+        return false;
+    }
+    mapping_ = mapping;
+    data_ = static_cast<char*>(view);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(static_cast<HANDLE>(mapping_));
+    if (file_) CloseHandle(static_cast<HANDLE>(file_));
+    data_ = nullptr;
+    mapping_ = nullptr;
+    file_ = nullptr;
+    size_ = 0;
+    opened_ = false;
+}
+
+bool MappedFile::sync(size_t offset, size_t length) {
+    if (!data_ || !writable_ || offset >= size_) return true;
+    if (length > size_ - offset) length = size_ - offset;
+    return FlushViewOfFile(data_ + offset, length) && FlushFileBuffers(static_cast<HANDLE>(file_));
+}
+
+#else
+
+bool MappedFile::open(const std::string& path, Mode mode, size_t size) {
+    close();
+    writable_ = mode == Mode::ReadWrite;
+
+    int fd = ::open(path.c_str(), writable_ ? (O_RDWR | O_CREAT | O_CLOEXEC) : (O_RDONLY | O_CLOEXEC), 0644);
+    if (fd < 0) {
+        cerr << "Error: could not open " << path << "." << endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    size_t file_size = static_cast<size_t>(st.st_size);
+    if (writable_ && size > file_size) {
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            cerr << "Error: could not size " << path << " to " << size << " bytes." << endl;
+            ::close(fd);
+            return false;
+        }
+        file_size = size;
+    }
+
+    fd_ = fd;
+    path_ = path;
+    size_ = file_size;
+    opened_ = true;
+    if (file_size == 0) return true; // mmap rejects empty ranges
+
+    void* addr = mmap(nullptr, file_size, writable_ ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        cerr << "Error: could not map " << path << "." << endl;
+        close();
+        return false;
+    }
+    data_ = static_cast<char*>(addr);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) munmap(data_, size_);
+    if (fd_ >= 0) ::close(fd_);
+    data_ = nullptr;
+    fd_ = -1;
+    size_ = 0;
+    opened_ = false;
+}
+
+bool MappedFile::sync(size_t offset, size_t length) {
+    if (!data_ || !writable_ || offset >= size_) return true;
+    if (length > size_ - offset) length = size_ - offset;
+
+    // msync needs a page-aligned start
+    static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t start = offset - offset % page;
+    if (msync(data_ + start, length + (offset - start), MS_SYNC) != 0) return false;
+#if defined(__APPLE__)
+    return fsync(fd_) == 0;
+#else
+    return fdatasync(fd_) == 0;
+#endif
+}
+
+#endif
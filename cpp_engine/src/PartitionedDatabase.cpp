@@ -0,0 +1,397 @@
+#include "../include/PartitionedDatabase.h"
+#include "../include/UtcTime.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char* PARTITION_PREFIX = "crypto_data_";
+static const long long NO_PARTITION = LLONG_MIN;
+
+PartitionedDatabase::PartitionedDatabase(PersistenceManager& catalog, long long interval_ms, const std::string& directory)
+    : catalog_(catalog), interval_ms_(interval_ms), directory_(directory), newest_(NO_PARTITION),
+      prepare_start_(NO_PARTITION), opening_(NO_PARTITION), writer_newest_(NO_PARTITION), awaited_(NO_PARTITION) {}
+
+PartitionedDatabase::~PartitionedDatabase() {
+    close();
+}
+
+bool PartitionedDatabase::open(const DbConfig& config) {
+    if (!catalog_.table_schema(PARTITIONED_TABLES, schema_)) {
+        cerr << "[PARTITION] Could not read the partition schema from " << catalog_.path() << "." << endl;
+        return false;
+    }
+    error_code ec;
+    fs::create_directories(directory_, ec);
+    if (ec) {
+        cerr << "[PARTITION] Could not create " << directory_ << ": " << ec.message() << endl;
+        return false;
+    }
+    config_ = config;
+    if (!migrate_partitions()) return false;
+
+    // Live trades land in the current interval first, so have it ready
+    long long now_ms = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+    roll_stop_ = false;
+    prepare_start_ = floor_to_interval(now_ms, interval_ms_);
+    roller_ = std::thread(&PartitionedDatabase::roller_loop, this);
+    cout << "[PARTITION] " << interval_ms_ / HOUR_MS << "h partitions in " << directory_ << endl;
+    return true;
+}
+
+void PartitionedDatabase::close() {
+    if (roller_.joinable()) {
+        {
+            lock_guard<mutex> lock(roll_mutex_);
+            roll_stop_ = true;
+        }
+        roll_cv_.notify_all();
+        roller_.join();
+    }
+    for (auto& entry : open_) entry.second->close_db();
+    for (auto& entry : prepared_) entry.second->close_db();
+    for (auto& db : retired_) db->close_db();
+    open_.clear();
+    prepared_.clear();
+    retired_.clear();
+    touched_.clear();
+    in_transaction_ = false;
+    newest_ = NO_PARTITION;
+    prepare_start_ = writer_newest_ = NO_PARTITION;
+    reader_.close_db();
+    reader_files_.clear();
+}
+
+std::string PartitionedDatabase::partition_path(long long start_ms) const {
+    string name = PARTITION_PREFIX + utc_date(start_ms);
+    if (interval_ms_ < DAY_MS) {
+        int hour_of_day = static_cast<int>((start_ms - floor_to_interval(start_ms, DAY_MS)) / HOUR_MS); // 0-23
+        char hour[8];
+        snprintf(hour, sizeof(hour), "T%02d", hour_of_day);
+        name += hour;
+    }
+    return (fs::path(directory_) / (name + ".db")).string();
+}
+
+std::vector<DbPartition> PartitionedDatabase::partitions(long long from_ms, long long to_ms) const {
+    vector<DbPartition> found;
+    error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory_, ec)) {
+        string name = entry.path().filename().string();
+        if (entry.path().extension() != ".db" || name.rfind(PARTITION_PREFIX, 0) != 0) continue;
+
+        // crypto_data_YYYY-MM-DD[THH].db
+        string stamp = name.substr(strlen(PARTITION_PREFIX), name.size() - strlen(PARTITION_PREFIX) - 3);
+        long long start;
+        if (!parse_utc_date(stamp, start)) continue;
+        if (stamp.size() == 13 && stamp[10] == 'T') {
+            start += atoll(stamp.c_str() + 11) * HOUR_MS;
+        } else if (stamp.size() != 10) {
+            continue;
+        }
+        if (start <= to_ms && start + interval_ms_ > from_ms) found.push_back(DbPartition{start, entry.path().string()});
+    }
+    sort(found.begin(), found.end(), [](const DbPartition& a, const DbPartition& b) { return a.start_ms < b.start_ms; });
+    return found;
+}
+
+// Older partitions would not line up with the catalog's tables in the reader's views
+bool PartitionedDatabase::migrate_partitions() {
+    DbConfig config;
+    config.checkpoint_interval_ms = 0;
+    config.wal_autocheckpoint = 1000;
+    for (const DbPartition& partition : partitions(LLONG_MIN, LLONG_MAX)) {
+        if (PersistenceManager::schema_version(partition.path) >= SCHEMA_VERSION) continue;
+        PersistenceManager db;
+        db.set_symbol_catalog(catalog_);
+        if (!db.open_db(partition.path, config)) {
+            cerr << "[PARTITION] Could not migrate " << partition.path << "." << endl;
+            return false;
+        }
+        db.close_db();
+    }
+    return true;
+}
+
+// --- Writer side ---
+
+std::unique_ptr<PersistenceManager> PartitionedDatabase::open_partition(long long start_ms) {
+    auto db = make_unique<PersistenceManager>();
+    db->set_symbol_catalog(catalog_);
+    if (!db->open_db(partition_path(start_ms), config_, schema_)) {
+        cerr << "[PARTITION] Could not open " << partition_path(start_ms) << "." << endl;
+        return nullptr;
+    }
+    return db;
+}
+
+PersistenceManager* PartitionedDatabase::partition_for(long long timestamp_ms) {
+    long long start = floor_to_interval(timestamp_ms, interval_ms_);
+    PersistenceManager* partition;
+    auto it = open_.find(start);
+    if (it != open_.end()) {
+        partition = it->second.get();
+    } else {
+        unique_ptr<PersistenceManager> db;
+        {
+            unique_lock<mutex> lock(roll_mutex_);
+            // Opening the file a second time would leave the opener's connection unused
+            if (opening_ == start) {
+                awaited_ = start;
+                roll_cv_.wait(lock, [&] { return opening_ != start; });
+                awaited_ = NO_PARTITION;
+            }
+            auto ready = prepared_.find(start);
+            if (ready != prepared_.end()) {
+                db = std::move(ready->second);
+                prepared_.erase(ready);
+            }
+            // Claimed before an inline open, so the opener does not open it as well
+            writer_newest_ = max(writer_newest_, start);
+        }
+        if (!db) db = open_partition(start); // A late trade, or no lead time: open it inline
+        if (!db) return nullptr;
+        partition = db.get();
+        open_.emplace(start, std::move(db));
+
+        if (start > newest_) {
+            newest_ = start;
+            cout << "[PARTITION] Writing to " << partition->path() << endl;
+            {
+                lock_guard<mutex> lock(roll_mutex_);
+                prepare_start_ = start + interval_ms_;
+                // Intervals the writer skipped (no trades in them) are closed; a late trade reopens its file
+                while (!prepared_.empty() && prepared_.begin()->first <= start) {
+                    retired_.push_back(std::move(prepared_.begin()->second));
+                    prepared_.erase(prepared_.begin());
+                }
+            }
+            roll_cv_.notify_all();
+        }
+    }
+
+    // Each partition joins the group commit the first time the group writes to it
+    if (in_transaction_ && touched_.count(start) == 0) {
+        if (!partition->begin_transaction()) return nullptr;
+        touched_.emplace(start, partition);
+    }
+    return partition;
+}
+
+template <typename Row, typename TimeOf, typename Insert>
+bool PartitionedDatabase::route(const std::vector<Row>& rows, TimeOf time_of, Insert insert) {
+    if (rows.empty()) return true;
+
+    // Usually the whole batch falls into one interval
+    long long first = floor_to_interval(time_of(rows.front()), interval_ms_);
+    bool single = all_of(rows.begin(), rows.end(),
+                         [&](const Row& row) { return floor_to_interval(time_of(row), interval_ms_) == first; });
+    if (single) {
+        PersistenceManager* partition = partition_for(first);
+        return partition && insert(*partition, rows);
+    }
+
+    map<long long, vector<Row>> split;
+    for (const Row& row : rows) split[floor_to_interval(time_of(row), interval_ms_)].push_back(row);
+    for (const auto& part : split) {
+        PersistenceManager* partition = partition_for(part.first);
+        if (!partition || !insert(*partition, part.second)) return false;
+    }
+    return true;
+}
+
+bool PartitionedDatabase::insert_raw_batch(const std::vector<TickerData>& rows) {
+    return route(rows, [](const TickerData& row) { return row.timestamp_ms; },
+                 [](PersistenceManager& db, const vector<TickerData>& part) { return db.insert_raw_batch(part); });
+}
+
+bool PartitionedDatabase::insert_metrics_batch(const std::vector<MetricRow>& rows, bool replace) {
+    return route(rows, [](const MetricRow& row) { return row.timestamp_ms; },
+                 [replace](PersistenceManager& db, const vector<MetricRow>& part) {
+                     return db.insert_metrics_batch(part, replace);
+                 });
+}
+
+bool PartitionedDatabase::insert_bars_batch(const std::vector<Candle>& bars) {
+    return route(bars, [](const Candle& bar) { return bar.open_time_ms; },
+                 [](PersistenceManager& db, const vector<Candle>& part) { return db.insert_bars_batch(part); });
+}
+
+bool PartitionedDatabase::insert_indicator_batch(const std::vector<IndicatorValue>& values) {
+    return route(values, [](const IndicatorValue& value) { return value.timestamp_ms; },
+                 [](PersistenceManager& db, const vector<IndicatorValue>& part) {
+                     return db.insert_indicator_batch(part);
+                 });
+}
+
+bool PartitionedDatabase::begin_transaction() {
+    touched_.clear();
+    in_transaction_ = true;
+    return true;
+}
+
+bool PartitionedDatabase::commit_transaction() {
+    // Oldest first; on failure the caller rolls back the partitions not committed yet
+    while (!touched_.empty()) {
+        if (!touched_.begin()->second->commit_transaction()) return false;
+        touched_.erase(touched_.begin());
+    }
+    in_transaction_ = false;
+    retire_old_partitions();
+    return true;
+}
+
+bool PartitionedDatabase::rollback_transaction() {
+    bool ok = true;
+    for (const auto& entry : touched_) ok = entry.second->rollback_transaction() && ok;
+    touched_.clear();
+    in_transaction_ = false;
+    return ok;
+}
+
+// Hands partitions beyond the DB_PARTITIONS_OPEN newest to the background thread to close
+void PartitionedDatabase::retire_old_partitions() {
+    if (open_.size() <= DB_PARTITIONS_OPEN) return;
+    {
+        lock_guard<mutex> lock(roll_mutex_);
+        while (open_.size() > DB_PARTITIONS_OPEN) {
+            retired_.push_back(std::move(open_.begin()->second));
+            open_.erase(open_.begin());
+        }
+    }
+    roll_cv_.notify_one();
+}
+
+void PartitionedDatabase::roller_loop() {
+    unique_lock<mutex> lock(roll_mutex_);
+    while (true) {
+        roll_cv_.wait(lock, [this] { return roll_stop_ || !retired_.empty() || prepare_start_ != NO_PARTITION; });
+        if (roll_stop_) break;
+
+        vector<unique_ptr<PersistenceManager>> retiring;
+        retiring.swap(retired_);
+        long long start = prepare_start_;
+        prepare_start_ = NO_PARTITION;
+        // The writer already has it (opened inline), or it is ready
+        if (start <= writer_newest_ || prepared_.count(start) > 0) start = NO_PARTITION;
+        opening_ = start;
+        lock.unlock();
+
+        for (auto& db : retiring) db->close_db(); // Runs the final checkpoint
+        retiring.clear();
+        unique_ptr<PersistenceManager> db;
+        if (start != NO_PARTITION) db = open_partition(start);
+
+        lock.lock();
+        opening_ = NO_PARTITION;
+        if (db) {
+            // The writer moved past it meanwhile: keep it only for a late trade waiting on it
+            if (start <= writer_newest_ && start != awaited_) {
+                retired_.push_back(std::move(db));
+            } else {
+                prepared_.emplace(start, std::move(db));
+            }
+        }
+        roll_cv_.notify_all(); // Wakes partition_for waiting on opening_
+    }
+}
+
+// --- Read side ---
+
+bool PartitionedDatabase::open_catalog_reader(PersistenceManager& reader) const {
+    DbConfig config;
+    config.checkpoint_interval_ms = 0; // Reads only; the catalog's own connection checkpoints it
+    config.wal_autocheckpoint = 1000;
+    return reader.open_db(catalog_.path(), config);
+}
+
+bool PartitionedDatabase::open_reader(PersistenceManager& reader, long long from_ms, long long to_ms) const {
+    vector<string> paths;
+    for (const DbPartition& partition : partitions(from_ms, to_ms)) paths.push_back(partition.path);
+    if (!open_catalog_reader(reader)) return false;
+    if (!reader.attach_partitions(paths, PARTITIONED_TABLES)) {
+        reader.close_db();
+        return false;
+    }
+    return true;
+}
+
+template <typename Fn>
+bool PartitionedDatabase::for_each_window(PersistenceManager& reader, long long from_ms, long long to_ms, Fn fn) {
+    vector<DbPartition> found = partitions(from_ms, to_ms);
+    size_t window = max<size_t>(1, reader.max_attached());
+    for (size_t first = 0; first < found.size(); first += window) {
+        size_t last = min(found.size(), first + window);
+        vector<string> paths;
+        for (size_t i = first; i < last; ++i) paths.push_back(found[i].path);
+        if (!reader.attach_partitions(paths, PARTITIONED_TABLES)) return false;
+        if (!fn(found[first].start_ms, found[last - 1].start_ms + interval_ms_ - 1)) return false;
+    }
+    return true;
+}
+
+bool PartitionedDatabase::load_ticks(const std::string& symbol, TickColumns& out) {
+    out.clear();
+    PersistenceManager reader;
+    if (!open_catalog_reader(reader)) return false;
+
+    // Windows are disjoint and in time order, so appending keeps (open_time_ms, trade_id) order
+    TickColumns window_ticks;
+    bool ok = for_each_window(reader, LLONG_MIN, LLONG_MAX, [&](long long, long long) {
+        if (!reader.load_ticks(symbol, window_ticks)) return false;
+        out.timestamp_ms.insert(out.timestamp_ms.end(), window_ticks.timestamp_ms.begin(), window_ticks.timestamp_ms.end());
+        out.trade_id.insert(out.trade_id.end(), window_ticks.trade_id.begin(), window_ticks.trade_id.end());
+        out.close.insert(out.close.end(), window_ticks.close.begin(), window_ticks.close.end());
+        out.volume.insert(out.volume.end(), window_ticks.volume.begin(), window_ticks.volume.end());
+        return true;
+    });
+    reader.close_db();
+    return ok;
+}
+
+bool PartitionedDatabase::mark_stored(std::vector<TickerData>& ticks, size_t& stored) {
+    if (ticks.empty()) return true;
+    if (!reader_.is_open() && !open_catalog_reader(reader_)) return false;
+
+    auto range = minmax_element(ticks.begin(), ticks.end(), [](const TickerData& a, const TickerData& b) {
+        return a.timestamp_ms < b.timestamp_ms;
+    });
+    long long from_ms = range.first->timestamp_ms, to_ms = range.second->timestamp_ms;
+    vector<DbPartition> found = partitions(from_ms, to_ms);
+
+    // Replay batches are short stretches of time; keep the attached set while it still fits
+    if (found.size() <= reader_.max_attached()) {
+        vector<string> paths;
+        for (const DbPartition& partition : found) paths.push_back(partition.path);
+        if (paths != reader_files_) {
+            reader_files_.clear();
+            if (!reader_.attach_partitions(paths, PARTITIONED_TABLES)) return false;
+            reader_files_ = paths;
+        }
+        return reader_.mark_stored(ticks, stored);
+    }
+
+    // Sparse ticks spanning more partitions than one connection can attach
+    reader_files_.clear();
+    vector<TickerData> part;
+    vector<size_t> index;
+    return for_each_window(reader_, from_ms, to_ms, [&](long long window_from, long long window_to) {
+        part.clear();
+        index.clear();
+        for (size_t i = 0; i < ticks.size(); ++i) {
+            if (ticks[i].timestamp_ms >= window_from && ticks[i].timestamp_ms <= window_to) {
+                part.push_back(ticks[i]);
+                index.push_back(i);
+            }
+        }
+        if (!reader_.mark_stored(part, stored)) return false;
+        for (size_t j = 0; j < part.size(); ++j) ticks[index[j]].flags = part[j].flags;
+        return true;
+    });
+}
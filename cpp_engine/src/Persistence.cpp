@@ -1,38 +1,601 @@
 #include "../include/Persistence.h"
 #include "../include/sqlite3.h" 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
 
 using namespace std;
+namespace fs = std::filesystem;
 
-PersistenceManager::PersistenceManager() : db_handle(nullptr) {}
+static const char* INSERT_RAW_SQL =
+    "INSERT OR IGNORE INTO raw_ohlcv_data (symbol_id, open_time_ms, trade_id, open_price, high_price, low_price, close_price, volume, ingested_ms) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);";
+static const char* INSERT_METRICS_SQL =
+    "INSERT OR IGNORE INTO aggregated_metrics (symbol_id, open_time_ms, trade_id, vwap, simple_average, ema_20, ema_50) VALUES (?, ?, ?, ?, ?, ?, ?);";
+
+// Multi-row variants: "<prefix>(?, ...), (?, ...), ...;"
+static const char* INSERT_RAW_PREFIX =
+    "INSERT OR IGNORE INTO raw_ohlcv_data (symbol_id, open_time_ms, trade_id, open_price, high_price, low_price, close_price, volume, ingested_ms) VALUES ";
+static const char* INSERT_METRICS_PREFIX =
+    "INSERT OR IGNORE INTO aggregated_metrics (symbol_id, open_time_ms, trade_id, vwap, simple_average, ema_20, ema_50) VALUES ";
+static const char* REPLACE_METRICS_PREFIX =
+    "INSERT OR REPLACE INTO aggregated_metrics (symbol_id, open_time_ms, trade_id, vwap, simple_average, ema_20, ema_50) VALUES ";
+static const char* INSERT_BARS_PREFIX =
+    "INSERT INTO ohlcv_bars (symbol_id, interval_ms, open_time_ms, open_price, high_price, low_price, close_price, volume, quote_volume, trade_count) VALUES ";
+// A bar flushed partially on shutdown is merged with the rest of its bucket after a restart
+static const char* INSERT_BARS_SUFFIX =
+    " ON CONFLICT (symbol_id, interval_ms, open_time_ms) DO UPDATE SET"
+    " high_price = max(high_price, excluded.high_price), low_price = min(low_price, excluded.low_price),"
+    " close_price = excluded.close_price, volume = volume + excluded.volume,"
+    " quote_volume = quote_volume + excluded.quote_volume, trade_count = trade_count + excluded.trade_count";
+static const char* INSERT_INDICATORS_PREFIX =
+    "INSERT OR IGNORE INTO indicator_values (symbol_id, open_time_ms, trade_id, name, value) VALUES ";
+static const int RAW_COLUMNS = 9;
+static const int METRICS_COLUMNS = 7;
+static const int BAR_COLUMNS = 10;
+static const int INDICATOR_COLUMNS = 5;
+
+/**
+ * Schema migrations, MIGRATIONS[v] taking a database from user_version v to v + 1 inside
+ * one transaction. "{catalog}" names the database holding the symbols table: main, or
+ * the attached catalog when migrating a partition file.
+ *
+ * 0 -> 1: symbol names move to the symbols dimension; the hot tables become WITHOUT ROWID
+ * tables clustered by (symbol_id, open_time_ms, trade_id), dropping the rowid and the
+ * separate symbol/time indexes; ingestion_timestamp (local time text) becomes ingested_ms.
+ * Files from the original schema.sql have no ohlcv_bars / indicator_values yet; they get
+ * empty v0 copies first so every file takes the same path.
+ */
+static const char* MIGRATIONS[SCHEMA_VERSION] = {
+    "CREATE TABLE IF NOT EXISTS main.ohlcv_bars (symbol TEXT NOT NULL, interval_ms INTEGER NOT NULL, open_time_ms INTEGER NOT NULL,"
+    " open_price REAL NOT NULL, high_price REAL NOT NULL, low_price REAL NOT NULL, close_price REAL NOT NULL,"
+    " volume REAL NOT NULL, quote_volume REAL NOT NULL, trade_count INTEGER NOT NULL, PRIMARY KEY (symbol, interval_ms, open_time_ms));"
+    "CREATE TABLE IF NOT EXISTS main.indicator_values (trade_id INTEGER NOT NULL, symbol TEXT NOT NULL, open_time_ms INTEGER NOT NULL,"
+    " name TEXT NOT NULL, value REAL, PRIMARY KEY (trade_id, symbol, name));"
+
+    "CREATE TABLE IF NOT EXISTS {catalog}.symbols (symbol_id INTEGER PRIMARY KEY, symbol TEXT NOT NULL UNIQUE);"
+    "INSERT OR IGNORE INTO {catalog}.symbols (symbol)"
+    " SELECT symbol FROM main.raw_ohlcv_data UNION SELECT symbol FROM main.aggregated_metrics"
+    " UNION SELECT symbol FROM main.ohlcv_bars UNION SELECT symbol FROM main.indicator_values ORDER BY 1;"
+
+    "ALTER TABLE main.raw_ohlcv_data RENAME TO raw_ohlcv_data_v0;"
+    "CREATE TABLE main.raw_ohlcv_data (symbol_id INTEGER NOT NULL, open_time_ms INTEGER NOT NULL, trade_id INTEGER NOT NULL,"
+    " open_price REAL NOT NULL, high_price REAL NOT NULL, low_price REAL NOT NULL, close_price REAL NOT NULL,"
+    " volume REAL NOT NULL, ingested_ms INTEGER NOT NULL, PRIMARY KEY (symbol_id, open_time_ms, trade_id)) WITHOUT ROWID;"
+    "INSERT OR IGNORE INTO main.raw_ohlcv_data SELECT s.symbol_id, r.open_time_ms, r.trade_id, r.open_price, r.high_price,"
+    " r.low_price, r.close_price, r.volume, coalesce(strftime('%s', r.ingestion_timestamp, 'utc') * 1000, 0)"
+    " FROM main.raw_ohlcv_data_v0 r JOIN {catalog}.symbols s ON s.symbol = r.symbol ORDER BY 1, 2, 3;"
+    "DROP TABLE main.raw_ohlcv_data_v0;"
+
+    "ALTER TABLE main.aggregated_metrics RENAME TO aggregated_metrics_v0;"
+    "CREATE TABLE main.aggregated_metrics (symbol_id INTEGER NOT NULL, open_time_ms INTEGER NOT NULL, trade_id INTEGER NOT NULL,"
+    " vwap REAL, simple_average REAL, ema_20 REAL, ema_50 REAL, PRIMARY KEY (symbol_id, open_time_ms, trade_id)) WITHOUT ROWID;"
+    "INSERT OR IGNORE INTO main.aggregated_metrics SELECT s.symbol_id, m.open_time_ms, m.trade_id, m.vwap, m.simple_average,"
+    " m.ema_20, m.ema_50 FROM main.aggregated_metrics_v0 m JOIN {catalog}.symbols s ON s.symbol = m.symbol ORDER BY 1, 2, 3;"
+    "DROP TABLE main.aggregated_metrics_v0;"
+
+    "ALTER TABLE main.ohlcv_bars RENAME TO ohlcv_bars_v0;"
+    "CREATE TABLE main.ohlcv_bars (symbol_id INTEGER NOT NULL, interval_ms INTEGER NOT NULL, open_time_ms INTEGER NOT NULL,"
+    " open_price REAL NOT NULL, high_price REAL NOT NULL, low_price REAL NOT NULL, close_price REAL NOT NULL,"
+    " volume REAL NOT NULL, quote_volume REAL NOT NULL, trade_count INTEGER NOT NULL,"
+    " PRIMARY KEY (symbol_id, interval_ms, open_time_ms)) WITHOUT ROWID;"
+    "INSERT INTO main.ohlcv_bars SELECT s.symbol_id, b.interval_ms, b.open_time_ms, b.open_price, b.high_price, b.low_price,"
+    " b.close_price, b.volume, b.quote_volume, b.trade_count"
+    " FROM main.ohlcv_bars_v0 b JOIN {catalog}.symbols s ON s.symbol = b.symbol ORDER BY 1, 2, 3;"
+    "DROP TABLE main.ohlcv_bars_v0;"
+
+    "ALTER TABLE main.indicator_values RENAME TO indicator_values_v0;"
+    "CREATE TABLE main.indicator_values (symbol_id INTEGER NOT NULL, open_time_ms INTEGER NOT NULL, trade_id INTEGER NOT NULL,"
+    " name TEXT NOT NULL, value REAL, PRIMARY KEY (symbol_id, open_time_ms, trade_id, name)) WITHOUT ROWID;"
+    "INSERT OR IGNORE INTO main.indicator_values SELECT s.symbol_id, v.open_time_ms, v.trade_id, v.name, v.value"
+    " FROM main.indicator_values_v0 v JOIN {catalog}.symbols s ON s.symbol = v.symbol ORDER BY 1, 2, 3, 4;"
+    "DROP TABLE main.indicator_values_v0;",
+};
+
+// Binds one row starting at parameter `first` (1-based); `symbol_key` is the row's symbols.symbol_id
+static void bind_raw_row(sqlite3_stmt* stmt, int first, const TickerData& data, long long symbol_key, long long ingested_ms) {
+    sqlite3_bind_int64(stmt, first, symbol_key);
+    sqlite3_bind_int64(stmt, first + 1, data.timestamp_ms);
+    sqlite3_bind_int64(stmt, first + 2, data.trade_id);
+    sqlite3_bind_double(stmt, first + 3, data.open);
+    sqlite3_bind_double(stmt, first + 4, data.high);
+    sqlite3_bind_double(stmt, first + 5, data.low);
+    sqlite3_bind_double(stmt, first + 6, data.close);
+    sqlite3_bind_double(stmt, first + 7, data.volume);
+    sqlite3_bind_int64(stmt, first + 8, ingested_ms);
+}
+
+// Indicators still warming up report NaN, which sqlite3_bind_double stores as NULL
+static void bind_metric_row(sqlite3_stmt* stmt, int first, const MetricRow& row, long long symbol_key) {
+    sqlite3_bind_int64(stmt, first, symbol_key);
+    sqlite3_bind_int64(stmt, first + 1, row.timestamp_ms);
+    sqlite3_bind_int64(stmt, first + 2, row.trade_id);
+    sqlite3_bind_double(stmt, first + 3, row.vwap);
+    sqlite3_bind_double(stmt, first + 4, row.simple_average);
+    sqlite3_bind_double(stmt, first + 5, row.ema_20);
+    sqlite3_bind_double(stmt, first + 6, row.ema_50);
+}
+
+static void bind_indicator_row(sqlite3_stmt* stmt, int first, const IndicatorValue& row, long long symbol_key) {
+    sqlite3_bind_int64(stmt, first, symbol_key);
+    sqlite3_bind_int64(stmt, first + 1, row.timestamp_ms);
+    sqlite3_bind_int64(stmt, first + 2, row.trade_id);
+    sqlite3_bind_text(stmt, first + 3, row.name.data(), (int)row.name.size(), SQLITE_STATIC);
+    sqlite3_bind_double(stmt, first + 4, row.value);
+}
+
+static void bind_bar_row(sqlite3_stmt* stmt, int first, const Candle& bar, long long symbol_key) {
+    sqlite3_bind_int64(stmt, first, symbol_key);
+    sqlite3_bind_int64(stmt, first + 1, bar.interval_ms);
+    sqlite3_bind_int64(stmt, first + 2, bar.open_time_ms);
+    sqlite3_bind_double(stmt, first + 3, bar.open);
+    sqlite3_bind_double(stmt, first + 4, bar.high);
+    sqlite3_bind_double(stmt, first + 5, bar.low);
+    sqlite3_bind_double(stmt, first + 6, bar.close);
+    sqlite3_bind_double(stmt, first + 7, bar.volume);
+    sqlite3_bind_double(stmt, first + 8, bar.quote_volume);
+    sqlite3_bind_int64(stmt, first + 9, bar.trade_count);
+}
+
+static long long unix_ms() {
+    return chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+}
+
+PersistenceManager::PersistenceManager()
+    : db_handle(nullptr), insert_raw_stmt_(nullptr), insert_metrics_stmt_(nullptr), rows_per_insert_(1),
+      symbol_catalog_(this) {}
 
 PersistenceManager::~PersistenceManager() {
     close_db();
 }
 
 
-bool PersistenceManager::open_db() {
+bool PersistenceManager::open_db(const std::string& path, const DbConfig& config, const std::string& schema) {
 
-    int rc = sqlite3_open(DB_FILE.c_str(), (sqlite3**)&db_handle);
+    int rc = sqlite3_open(path.c_str(), (sqlite3**)&db_handle);
 
     if (rc) {
         cerr << "Can't open database: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
+        sqlite3_close((sqlite3*)db_handle);
         db_handle = nullptr;
         return false;
-    } else {
-        cout << "Database successfully opened: " << DB_FILE << endl;
-        return true;
     }
+
+    db_path_ = path;
+    config_ = config;
+    if (!apply_pragmas(config) || (!schema.empty() && !create_schema(schema)) || !migrate_schema()) {
+        close_db();
+        return false;
+    }
+
+    if (!prepare_statements()) {
+        cerr << "Database schema missing? Initialize it with db_setup/schema.sql." << endl;
+        close_db();
+        return false;
+    }
+
+    start_checkpointer();
+    cout << "Database successfully opened: " << path << endl;
+    return true;
 }
 
 void PersistenceManager::close_db() {
     if (db_handle) {
+        stop_checkpointer();
+        finalize_statements();
         sqlite3_close((sqlite3*)db_handle);
         db_handle = nullptr;
+        attached_ = 0;
+        views_.clear();
+        lock_guard<mutex> lock(symbols_mutex_);
+        symbol_keys_.clear();
+        uncommitted_symbols_.clear();
         cout << "Database closed." << endl;
     }
 }
 
+// --- Connection Configuration ---
+
+// Runs a PRAGMA and returns its first result column (empty if none)
+static string run_pragma(sqlite3* db, const string& sql) {
+    string result;
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, 0) != SQLITE_OK) {
+        cerr << "PRAGMA error (" << sql << "): " << sqlite3_errmsg(db) << endl;
+        return result;
+    }
+    if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_text(stmt, 0)) {
+        result = (const char*)sqlite3_column_text(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return result;
+}
+
+bool PersistenceManager::apply_pragmas(const DbConfig& config) {
+    sqlite3* db = (sqlite3*)db_handle;
+    sqlite3_busy_timeout(db, config.busy_timeout_ms);
+
+    // page_size must precede the switch to WAL to apply to a fresh database
+    run_pragma(db, "PRAGMA page_size = " + to_string(config.page_size) + ";");
+
+    string mode = run_pragma(db, "PRAGMA journal_mode = " + config.journal_mode + ";");
+    if (mode.empty()) return false;
+    cout << "[DB] journal_mode=" << mode << endl;
+
+    int autocheckpoint = config.wal_autocheckpoint;
+    if (autocheckpoint == 0 && config.checkpoint_interval_ms <= 0) {
+        cerr << "Warning: no background checkpointer and wal_autocheckpoint=0; using SQLite's default of 1000 pages." << endl;
+        autocheckpoint = 1000;
+    }
+
+    return execute_sql(("PRAGMA synchronous = " + config.synchronous + ";").c_str()) &&
+           execute_sql(("PRAGMA cache_size = -" + to_string(config.cache_size_kib) + ";").c_str()) &&
+           execute_sql(("PRAGMA temp_store = " + config.temp_store + ";").c_str()) &&
+           execute_sql(("PRAGMA wal_autocheckpoint = " + to_string(autocheckpoint) + ";").c_str()) &&
+           !run_pragma(db, "PRAGMA mmap_size = " + to_string(config.mmap_size) + ";").empty();
+}
+
+// --- Schema and Partitions ---
+
+bool PersistenceManager::table_schema(const std::vector<std::string>& tables, std::string& sql) {
+    if (!db_handle) return false;
+    sql.clear();
+
+    sqlite3_stmt* stmt;
+    const char* query = "SELECT sql FROM sqlite_master WHERE tbl_name = ? AND sql IS NOT NULL "
+                        "ORDER BY type = 'index', name;"; // Each table before its indexes
+    if (sqlite3_prepare_v2((sqlite3*)db_handle, query, -1, &stmt, 0) != SQLITE_OK) {
+        cerr << "SQL error on prepare: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
+        return false;
+    }
+    bool ok = true;
+    for (const string& table : tables) {
+        sqlite3_reset(stmt);
+        sqlite3_bind_text(stmt, 1, table.c_str(), (int)table.size(), SQLITE_TRANSIENT);
+        bool found = false;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            sql += (const char*)sqlite3_column_text(stmt, 0);
+            sql += ";\n";
+            found = true;
+        }
+        if (!found) {
+            cerr << "Table " << table << " missing from " << db_path_ << "." << endl;
+            ok = false;
+        }
+    }
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+// BEGIN IMMEDIATE serializes two connections initializing the same new file
+bool PersistenceManager::create_schema(const std::string& schema) {
+    if (!execute_sql("BEGIN IMMEDIATE;")) return false;
+
+    sqlite3_stmt* stmt;
+    int tables = -1;
+    if (sqlite3_prepare_v2((sqlite3*)db_handle, "SELECT count(*) FROM sqlite_master WHERE type = 'table';", -1, &stmt, 0) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) tables = sqlite3_column_int(stmt, 0);
+        sqlite3_finalize(stmt);
+    }
+    // The schema comes from an up-to-date catalog, so the new file needs no migration
+    bool ok = tables == 0 ? execute_sql(schema.c_str()) &&
+                                execute_sql(("PRAGMA user_version = " + to_string(SCHEMA_VERSION) + ";").c_str())
+                          : tables > 0;
+    return execute_sql(ok ? "COMMIT;" : "ROLLBACK;") && ok;
+}
+
+int PersistenceManager::schema_version(const std::string& path) {
+    sqlite3* db = nullptr;
+    int version = -1;
+    if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) == SQLITE_OK) {
+        string value = run_pragma(db, "PRAGMA user_version;");
+        if (!value.empty()) version = atoi(value.c_str());
+    }
+    sqlite3_close(db);
+    return version;
+}
+
+bool PersistenceManager::migrate_schema() {
+    sqlite3* db = (sqlite3*)db_handle;
+    int version = atoi(run_pragma(db, "PRAGMA user_version;").c_str());
+    if (version > SCHEMA_VERSION) {
+        cerr << db_path_ << " has schema version " << version << "; this engine knows up to " << SCHEMA_VERSION << "." << endl;
+        return false;
+    }
+    if (version == SCHEMA_VERSION || atoi(run_pragma(db, "SELECT count(*) FROM sqlite_master WHERE type = 'table';").c_str()) == 0) {
+        return true; // Current, or empty (tables come from schema.sql or create_schema())
+    }
+
+    string catalog = "main";
+    if (symbol_catalog_ != this) {
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, "ATTACH DATABASE ? AS catalog;", -1, &stmt, 0) != SQLITE_OK) return false;
+        const string& catalog_path = symbol_catalog_->path();
+        sqlite3_bind_text(stmt, 1, catalog_path.c_str(), (int)catalog_path.size(), SQLITE_TRANSIENT);
+        int rc = sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+        if (rc != SQLITE_DONE) {
+            cerr << "Could not attach the catalog " << catalog_path << ": " << sqlite3_errmsg(db) << endl;
+            return false;
+        }
+        catalog = "catalog";
+    }
+
+    auto started = chrono::steady_clock::now();
+    bool ok = execute_sql("BEGIN IMMEDIATE;");
+    for (int v = version; ok && v < SCHEMA_VERSION; ++v) {
+        string sql = MIGRATIONS[v];
+        for (size_t at = sql.find("{catalog}"); at != string::npos; at = sql.find("{catalog}", at)) {
+            sql.replace(at, 9, catalog);
+        }
+        ok = execute_sql(sql.c_str());
+    }
+    ok = ok && execute_sql(("PRAGMA user_version = " + to_string(SCHEMA_VERSION) + ";").c_str());
+    ok = execute_sql(ok ? "COMMIT;" : "ROLLBACK;") && ok;
+    if (catalog != "main") execute_sql("DETACH DATABASE catalog;");
+
+    if (!ok) {
+        cerr << "[DB] Migrating " << db_path_ << " from schema version " << version << " failed; the file is unchanged." << endl;
+        return false;
+    }
+    cout << "[DB] Migrated " << db_path_ << " from schema version " << version << " to " << SCHEMA_VERSION << " in "
+         << chrono::duration<double>(chrono::steady_clock::now() - started).count() << " s" << endl;
+
+    // The old tables' pages are now on the free list: new rows reuse them, --vacuum returns them
+    long long free_bytes = atoll(run_pragma(db, "PRAGMA freelist_count;").c_str()) * atoll(run_pragma(db, "PRAGMA page_size;").c_str());
+    cout << "[DB] " << free_bytes / (1024 * 1024) << " MB of " << db_path_
+         << " is free space left by the old tables; run with --vacuum to return it to the OS." << endl;
+    return true;
+}
+
+bool PersistenceManager::vacuum() {
+    if (!db_handle) return false;
+    sqlite3* db = (sqlite3*)db_handle;
+    long long page_size = atoll(run_pragma(db, "PRAGMA page_size;").c_str());
+    long long free_bytes = atoll(run_pragma(db, "PRAGMA freelist_count;").c_str()) * page_size;
+    long long used_bytes = atoll(run_pragma(db, "PRAGMA page_count;").c_str()) * page_size - free_bytes;
+
+    // VACUUM writes a temporary copy of the live pages and then the rewritten file through the WAL
+    error_code ec;
+    fs::space_info disk = fs::space(fs::absolute(db_path_).parent_path(), ec);
+    if (!ec && (long long)disk.available < 2 * used_bytes) {
+        cerr << "[DB] Not vacuuming " << db_path_ << ": it needs about " << 2 * used_bytes / (1024 * 1024)
+             << " MB of free disk space, " << disk.available / (1024 * 1024) << " MB available." << endl;
+        return false;
+    }
+    cout << "[DB] Vacuuming " << db_path_ << " (" << used_bytes / (1024 * 1024) << " MB in use, " << free_bytes / (1024 * 1024)
+         << " MB free); writes to it wait until this finishes..." << endl;
+
+    auto started = chrono::steady_clock::now();
+    if (!execute_sql("VACUUM;")) return false;
+    execute_sql("PRAGMA wal_checkpoint(TRUNCATE);");
+    cout << "[DB] Vacuumed " << db_path_ << " in " << chrono::duration<double>(chrono::steady_clock::now() - started).count()
+         << " s, " << free_bytes / (1024 * 1024) << " MB returned to the OS" << endl;
+    return true;
+}
+
+// --- Symbols Dimension ---
+
+long long PersistenceManager::symbol_key(SymbolId id, bool create) {
+    lock_guard<mutex> lock(symbols_mutex_);
+    if (id < symbol_keys_.size() && symbol_keys_[id] != 0) return symbol_keys_[id];
+    if (!db_handle) return 0;
+
+    sqlite3* db = (sqlite3*)db_handle;
+    string_view name = symbol_name(id);
+    sqlite3_stmt* stmt;
+    if (create) {
+        if (sqlite3_prepare_v2(db, "INSERT OR IGNORE INTO symbols (symbol) VALUES (?);", -1, &stmt, 0) != SQLITE_OK) {
+            cerr << "SQL error on prepare: " << sqlite3_errmsg(db) << endl;
+            return 0;
+        }
+        sqlite3_bind_text(stmt, 1, name.data(), (int)name.size(), SQLITE_STATIC);
+        int rc = sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+        if (rc != SQLITE_DONE) {
+            cerr << "Symbol insertion failed: " << sqlite3_errmsg(db) << endl;
+            return 0;
+        }
+        // Inside the writer's transaction the new id only exists if that transaction commits
+        if (sqlite3_changes(db) > 0 && !sqlite3_get_autocommit(db)) uncommitted_symbols_.push_back(id);
+    }
+
+    long long key = 0;
+    if (sqlite3_prepare_v2(db, "SELECT symbol_id FROM symbols WHERE symbol = ?;", -1, &stmt, 0) != SQLITE_OK) {
+        cerr << "SQL error on prepare: " << sqlite3_errmsg(db) << endl;
+        return 0;
+    }
+    sqlite3_bind_text(stmt, 1, name.data(), (int)name.size(), SQLITE_STATIC);
+    if (sqlite3_step(stmt) == SQLITE_ROW) key = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+
+    if (key != 0) {
+        if (symbol_keys_.size() <= id) symbol_keys_.resize(id + 1, 0);
+        symbol_keys_[id] = key;
+    }
+    return key;
+}
+
+size_t PersistenceManager::max_attached() {
+    if (!db_handle) return 0;
+    // Raise the runtime limit to the compile-time maximum (10 by default, at most 125)
+    sqlite3_limit((sqlite3*)db_handle, SQLITE_LIMIT_ATTACHED, 125);
+    return (size_t)sqlite3_limit((sqlite3*)db_handle, SQLITE_LIMIT_ATTACHED, -1);
+}
+
+bool PersistenceManager::attach_partitions(const std::vector<std::string>& files, const std::vector<std::string>& tables) {
+    if (!db_handle) return false;
+    sqlite3* db = (sqlite3*)db_handle;
+
+    for (const string& view : views_) execute_sql(("DROP VIEW IF EXISTS temp." + view + ";").c_str());
+    views_.clear();
+    for (size_t i = 0; i < attached_; ++i) execute_sql(("DETACH DATABASE p" + to_string(i) + ";").c_str());
+    attached_ = 0;
+
+    if (files.size() > max_attached()) {
+        cerr << "Cannot attach " << files.size() << " partitions; SQLite allows " << max_attached() << "." << endl;
+        return false;
+    }
+    for (const string& file : files) {
+        sqlite3_stmt* stmt;
+        string sql = "ATTACH DATABASE ? AS p" + to_string(attached_) + ";";
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, 0) != SQLITE_OK) {
+            cerr << "SQL error on prepare: " << sqlite3_errmsg(db) << endl;
+            return false;
+        }
+        sqlite3_bind_text(stmt, 1, file.c_str(), (int)file.size(), SQLITE_TRANSIENT);
+        int rc = sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+        if (rc != SQLITE_DONE) {
+            cerr << "Could not attach " << file << ": " << sqlite3_errmsg(db) << endl;
+            return false;
+        }
+        ++attached_;
+    }
+
+    // TEMP objects resolve before main, so unqualified reads of `table` go through the view
+    for (const string& table : tables) {
+        string sql = "CREATE TEMP VIEW " + table + " AS ";
+        if (files.empty()) sql += "SELECT * FROM main." + table + " WHERE 0";
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (i > 0) sql += " UNION ALL ";
+            sql += "SELECT * FROM p" + to_string(i) + "." + table;
+        }
+        sql += ";";
+        if (!execute_sql(sql.c_str())) return false;
+        views_.push_back(table);
+    }
+    return true;
+}
+
+// --- Background Checkpointer ---
+
+void PersistenceManager::start_checkpointer() {
+    string mode = config_.journal_mode;
+    transform(mode.begin(), mode.end(), mode.begin(), ::toupper);
+    if (config_.checkpoint_interval_ms <= 0 || mode != "WAL") {
+        return;
+    }
+    checkpoint_stop_ = false;
+    checkpoint_thread_ = std::thread(&PersistenceManager::checkpoint_loop, this);
+}
+
+void PersistenceManager::stop_checkpointer() {
+    if (!checkpoint_thread_.joinable()) return;
+    {
+        lock_guard<mutex> lock(checkpoint_mutex_);
+        checkpoint_stop_ = true;
+    }
+    checkpoint_cv_.notify_all();
+    checkpoint_thread_.join();
+}
+
+void PersistenceManager::checkpoint_loop() {
+    sqlite3* db = nullptr;
+    if (sqlite3_open(db_path_.c_str(), &db) != SQLITE_OK) {
+        cerr << "Checkpointer: can't open database: " << sqlite3_errmsg(db) << endl;
+        sqlite3_close(db);
+        return;
+    }
+    sqlite3_busy_timeout(db, config_.busy_timeout_ms);
+    long long page_size = atoll(run_pragma(db, "PRAGMA page_size;").c_str());
+
+    unique_lock<mutex> lock(checkpoint_mutex_);
+    while (!checkpoint_stop_) {
+        checkpoint_cv_.wait_for(lock, chrono::milliseconds(config_.checkpoint_interval_ms));
+        if (checkpoint_stop_) break;
+        lock.unlock();
+
+        // PASSIVE copies whatever it can without ever blocking the writer
+        int wal_frames = 0, checkpointed = 0;
+        int rc = sqlite3_wal_checkpoint_v2(db, nullptr, SQLITE_CHECKPOINT_PASSIVE, &wal_frames, &checkpointed);
+
+        // A WAL that PASSIVE cannot keep up with is reset once readers allow it
+        if (rc == SQLITE_OK && wal_frames > 0 && wal_frames * page_size > config_.checkpoint_truncate_bytes) {
+            rc = sqlite3_wal_checkpoint_v2(db, nullptr, SQLITE_CHECKPOINT_TRUNCATE, &wal_frames, &checkpointed);
+            cout << "[DB] WAL truncated (" << checkpointed << " frames checkpointed)." << endl;
+        }
+        if (rc != SQLITE_OK && rc != SQLITE_BUSY) {
+            cerr << "Checkpoint failed: " << sqlite3_errmsg(db) << endl;
+        }
+
+        lock.lock();
+    }
+    lock.unlock();
+
+    // Final checkpoint on shutdown keeps the WAL small for the next start
+    sqlite3_wal_checkpoint_v2(db, nullptr, SQLITE_CHECKPOINT_TRUNCATE, nullptr, nullptr);
+    sqlite3_close(db);
+}
+
+bool PersistenceManager::prepare_statements() {
+    sqlite3* db = (sqlite3*)db_handle;
+    if (sqlite3_prepare_v2(db, INSERT_RAW_SQL, -1, (sqlite3_stmt**)&insert_raw_stmt_, 0) != SQLITE_OK ||
+        sqlite3_prepare_v2(db, INSERT_METRICS_SQL, -1, (sqlite3_stmt**)&insert_metrics_stmt_, 0) != SQLITE_OK) {
+        cerr << "SQL error on prepare: " << sqlite3_errmsg(db) << endl;
+        finalize_statements();
+        return false;
+    }
+
+    // Size full chunks to the compiled-in host parameter limit (999 on old builds, 32766 since 3.32),
+    // using the widest table so one chunk size fits every statement
+    size_t max_variables = (size_t)sqlite3_limit(db, SQLITE_LIMIT_VARIABLE_NUMBER, -1);
+    rows_per_insert_ = std::max<size_t>(1, std::min(MAX_ROWS_PER_INSERT, max_variables / BAR_COLUMNS));
+
+    // Pre-build the full-chunk statements; tail sizes are prepared on first use
+    if (!batch_statement(raw_batch_stmts_, INSERT_RAW_PREFIX, RAW_COLUMNS, rows_per_insert_) ||
+        !batch_statement(metrics_batch_stmts_, INSERT_METRICS_PREFIX, METRICS_COLUMNS, rows_per_insert_) ||
+        !batch_statement(bars_batch_stmts_, INSERT_BARS_PREFIX, BAR_COLUMNS, 1, INSERT_BARS_SUFFIX) ||
+        !batch_statement(indicator_batch_stmts_, INSERT_INDICATORS_PREFIX, INDICATOR_COLUMNS, 1)) {
+        finalize_statements();
+        return false;
+    }
+    return true;
+}
+
+void PersistenceManager::finalize_statements() {
+    sqlite3_finalize((sqlite3_stmt*)insert_raw_stmt_);
+    sqlite3_finalize((sqlite3_stmt*)insert_metrics_stmt_);
+    insert_raw_stmt_ = nullptr;
+    insert_metrics_stmt_ = nullptr;
+
+    for (void* stmt : raw_batch_stmts_) sqlite3_finalize((sqlite3_stmt*)stmt);
+    for (void* stmt : metrics_batch_stmts_) sqlite3_finalize((sqlite3_stmt*)stmt);
+    for (void* stmt : metrics_replace_stmts_) sqlite3_finalize((sqlite3_stmt*)stmt);
+    for (void* stmt : bars_batch_stmts_) sqlite3_finalize((sqlite3_stmt*)stmt);
+    for (void* stmt : indicator_batch_stmts_) sqlite3_finalize((sqlite3_stmt*)stmt);
+    raw_batch_stmts_.clear();
+    metrics_batch_stmts_.clear();
+    metrics_replace_stmts_.clear();
+    bars_batch_stmts_.clear();
+    indicator_batch_stmts_.clear();
+}
+
+void* PersistenceManager::batch_statement(std::vector<void*>& cache, const char* insert_prefix, int columns, size_t rows,
+                                          const char* insert_suffix) {
+    if (cache.size() <= rows) cache.resize(rows + 1, nullptr);
+    if (cache[rows]) return cache[rows];
+
+    string sql = insert_prefix;
+    string tuple = "(?";
+    for (int c = 1; c < columns; ++c) tuple += ", ?";
+    tuple += ")";
+    for (size_t r = 0; r < rows; ++r) {
+        if (r > 0) sql += ", ";
+        sql += tuple;
+    }
+    sql += insert_suffix;
+    sql += ";";
+
+    if (sqlite3_prepare_v2((sqlite3*)db_handle, sql.c_str(), -1, (sqlite3_stmt**)&cache[rows], 0) != SQLITE_OK) {
+        cerr << "SQL error on batch prepare (" << rows << " rows): " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
+        cache[rows] = nullptr;
+    }
+    return cache[rows];
+}
+
 // --- Data Insertion Logic ---
 
 bool PersistenceManager::insert_raw_data(const TickerData& data) {
@@ -41,69 +604,256 @@ bool PersistenceManager::insert_raw_data(const TickerData& data) {
         return false;
     }
 
-    const char* sql = "INSERT OR IGNORE INTO raw_ohlcv_data (open_time_ms, trade_id, symbol, open_price, high_price, low_price, close_price, volume) VALUES (?, ?, ?, ?, ?, ?, ?, ?);";
-    sqlite3_stmt* stmt;
-    
-    // Prepare the statement
-    int rc = sqlite3_prepare_v2((sqlite3*)db_handle, sql, -1, &stmt, 0);
-    if (rc != SQLITE_OK) {
-        cerr << "SQL error on prepare: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
-        return false;
-    }
+    sqlite3_stmt* stmt = (sqlite3_stmt*)insert_raw_stmt_;
+
+    long long symbol_key = symbol_catalog_->symbol_key(data.symbol_id, true);
+    if (symbol_key == 0) return false;
 
     // Bind parameters (Note: Indexing starts at 1)
-    sqlite3_bind_int64(stmt, 1, data.timestamp_ms);
-    sqlite3_bind_int64(stmt, 2, data.trade_id);
-    sqlite3_bind_text(stmt, 3, data.symbol.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_double(stmt, 4, data.open);
-    sqlite3_bind_double(stmt, 5, data.high);
-    sqlite3_bind_double(stmt, 6, data.low);
-    sqlite3_bind_double(stmt, 7, data.close);
-    sqlite3_bind_double(stmt, 8, data.volume);
-
-    // Execute the statement
-    rc = sqlite3_step(stmt);
-    
-    // Finalize the statement (clean up)
-    sqlite3_finalize(stmt);
+    bind_raw_row(stmt, 1, data, symbol_key, unix_ms());
 
+    // Execute, then make the cached statement ready for the next row
+    int rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE) {
         cerr << "Insertion failed: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
-        return false;
     }
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
     
     // cout << "Raw data inserted successfully." << endl;
-    return true;
+    return rc == SQLITE_DONE;
 }
 
 bool PersistenceManager::insert_metrics(long long timestamp, long long trade_id, const std::string& symbol, double vwap, double simple_avg, double ema_20, double ema_50) {
     if (!db_handle) return false;
 
-    // Prepared statement for aggregated metrics
-    const char* sql = "INSERT OR IGNORE INTO aggregated_metrics (open_time_ms, trade_id, symbol, vwap, simple_average, ema_20, ema_50) VALUES (?, ?, ?, ?, ?, ?, ?);";
-    sqlite3_stmt* stmt;
-    
-    int rc = sqlite3_prepare_v2((sqlite3*)db_handle, sql, -1, &stmt, 0);
-    if (rc != SQLITE_OK) {
-        cerr << "Metrics prepare error: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
-        return false;
-    }
+    sqlite3_stmt* stmt = (sqlite3_stmt*)insert_metrics_stmt_;
+    long long symbol_key = symbol_catalog_->symbol_key(intern_symbol(symbol), true);
+    if (symbol_key == 0) return false;
 
     // Bind parameters
-    sqlite3_bind_int64(stmt, 1, timestamp);
-    sqlite3_bind_int64(stmt, 2, trade_id);
-    sqlite3_bind_text(stmt, 3, symbol.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 1, symbol_key);
+    sqlite3_bind_int64(stmt, 2, timestamp);
+    sqlite3_bind_int64(stmt, 3, trade_id);
     sqlite3_bind_double(stmt, 4, vwap);
     sqlite3_bind_double(stmt, 5, simple_avg);
     sqlite3_bind_double(stmt, 6, ema_20);
     sqlite3_bind_double(stmt, 7, ema_50);
 
-    // Execute and finalize
-    rc = sqlite3_step(stmt);
+    // Execute and reset for reuse
+    int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_DONE) {
+        cerr << "Metrics insertion failed: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
+    }
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return rc == SQLITE_DONE;
+}
+
+bool PersistenceManager::insert_raw_batch(const std::vector<TickerData>& rows) {
+    if (!db_handle) {
+        cerr << "DB not open." << endl;
+        return false;
+    }
+
+    long long ingested_ms = unix_ms();
+    for (size_t offset = 0; offset < rows.size(); offset += rows_per_insert_) {
+        size_t chunk = std::min(rows_per_insert_, rows.size() - offset);
+        sqlite3_stmt* stmt = (sqlite3_stmt*)batch_statement(raw_batch_stmts_, INSERT_RAW_PREFIX, RAW_COLUMNS, chunk);
+        if (!stmt) return false;
+
+        for (size_t i = 0; i < chunk; ++i) {
+            const TickerData& row = rows[offset + i];
+            long long symbol_key = symbol_catalog_->symbol_key(row.symbol_id, true);
+            if (symbol_key == 0) return false;
+            bind_raw_row(stmt, (int)(i * RAW_COLUMNS) + 1, row, symbol_key, ingested_ms);
+        }
+        int rc = sqlite3_step(stmt);
+        if (rc != SQLITE_DONE) {
+            cerr << "Batch insertion failed: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
+        }
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        if (rc != SQLITE_DONE) return false;
+    }
+    return true;
+}
+
+bool PersistenceManager::insert_metrics_batch(const std::vector<MetricRow>& rows, bool replace) {
+    if (!db_handle) return false;
+
+    std::vector<void*>& cache = replace ? metrics_replace_stmts_ : metrics_batch_stmts_;
+    const char* prefix = replace ? REPLACE_METRICS_PREFIX : INSERT_METRICS_PREFIX;
+    for (size_t offset = 0; offset < rows.size(); offset += rows_per_insert_) {
+        size_t chunk = std::min(rows_per_insert_, rows.size() - offset);
+        sqlite3_stmt* stmt = (sqlite3_stmt*)batch_statement(cache, prefix, METRICS_COLUMNS, chunk);
+        if (!stmt) return false;
+
+        for (size_t i = 0; i < chunk; ++i) {
+            long long symbol_key = symbol_catalog_->symbol_key(rows[offset + i].symbol_id, true);
+            if (symbol_key == 0) return false;
+            bind_metric_row(stmt, (int)(i * METRICS_COLUMNS) + 1, rows[offset + i], symbol_key);
+        }
+        int rc = sqlite3_step(stmt);
+        if (rc != SQLITE_DONE) {
+            cerr << "Metrics batch insertion failed: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
+        }
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        if (rc != SQLITE_DONE) return false;
+    }
+    return true;
+}
+
+bool PersistenceManager::insert_bars_batch(const std::vector<Candle>& bars) {
+    if (!db_handle) return false;
+
+    for (size_t offset = 0; offset < bars.size(); offset += rows_per_insert_) {
+        size_t chunk = std::min(rows_per_insert_, bars.size() - offset);
+        sqlite3_stmt* stmt = (sqlite3_stmt*)batch_statement(bars_batch_stmts_, INSERT_BARS_PREFIX, BAR_COLUMNS, chunk, INSERT_BARS_SUFFIX);
+        if (!stmt) return false;
+
+        for (size_t i = 0; i < chunk; ++i) {
+            long long symbol_key = symbol_catalog_->symbol_key(bars[offset + i].symbol_id, true);
+            if (symbol_key == 0) return false;
+            bind_bar_row(stmt, (int)(i * BAR_COLUMNS) + 1, bars[offset + i], symbol_key);
+        }
+        int rc = sqlite3_step(stmt);
+        if (rc != SQLITE_DONE) {
+            cerr << "Bar batch insertion failed: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
+        }
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        if (rc != SQLITE_DONE) return false;
+    }
+    return true;
+}
+
+bool PersistenceManager::insert_indicator_batch(const std::vector<IndicatorValue>& values) {
+    if (!db_handle) return false;
+
+    for (size_t offset = 0; offset < values.size(); offset += rows_per_insert_) {
+        size_t chunk = std::min(rows_per_insert_, values.size() - offset);
+        sqlite3_stmt* stmt = (sqlite3_stmt*)batch_statement(indicator_batch_stmts_, INSERT_INDICATORS_PREFIX, INDICATOR_COLUMNS, chunk);
+        if (!stmt) return false;
+
+        for (size_t i = 0; i < chunk; ++i) {
+            long long symbol_key = symbol_catalog_->symbol_key(values[offset + i].symbol_id, true);
+            if (symbol_key == 0) return false;
+            bind_indicator_row(stmt, (int)(i * INDICATOR_COLUMNS) + 1, values[offset + i], symbol_key);
+        }
+        int rc = sqlite3_step(stmt);
+        if (rc != SQLITE_DONE) {
+            cerr << "Indicator batch insertion failed: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
+        }
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        if (rc != SQLITE_DONE) return false;
+    }
+    return true;
+}
+
+// --- Reads for backfill ---
+
+bool PersistenceManager::load_ticks(const std::string& symbol, TickColumns& out) {
+    if (!db_handle) return false;
+    out.clear();
+
+    sqlite3_stmt* stmt;
+    // One range of the (symbol_id, open_time_ms, trade_id) key, already in order
+    const char* sql = "SELECT open_time_ms, trade_id, close_price, volume FROM raw_ohlcv_data "
+                      "WHERE symbol_id = (SELECT symbol_id FROM symbols WHERE symbol = ?) ORDER BY open_time_ms, trade_id;";
+    if (sqlite3_prepare_v2((sqlite3*)db_handle, sql, -1, &stmt, 0) != SQLITE_OK) {
+        cerr << "SQL error on prepare: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
+        return false;
+    }
+    sqlite3_bind_text(stmt, 1, symbol.c_str(), (int)symbol.size(), SQLITE_STATIC);
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        out.timestamp_ms.push_back(sqlite3_column_int64(stmt, 0));
+        out.trade_id.push_back(sqlite3_column_int64(stmt, 1));
+        out.close.push_back(sqlite3_column_double(stmt, 2));
+        out.volume.push_back(sqlite3_column_double(stmt, 3));
+    }
+    if (rc != SQLITE_DONE) {
+        cerr << "Tick load failed: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
+    }
     sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+// --- Journal replay ---
+
+bool PersistenceManager::mark_stored(std::vector<TickerData>& ticks, size_t& stored) {
+    if (!db_handle) return false;
 
+    sqlite3_stmt* stmt;
+    const char* sql = "SELECT 1 FROM aggregated_metrics WHERE symbol_id = ? AND open_time_ms = ? AND trade_id = ?;";
+    if (sqlite3_prepare_v2((sqlite3*)db_handle, sql, -1, &stmt, 0) != SQLITE_OK) {
+        cerr << "SQL error on prepare: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
+        return false;
+    }
+
+    int rc = SQLITE_DONE;
+    for (TickerData& tick : ticks) {
+        // A symbol the database has never seen has nothing stored
+        long long symbol_key = symbol_catalog_->symbol_key(tick.symbol_id, false);
+        if (symbol_key == 0) continue;
+        sqlite3_reset(stmt);
+        sqlite3_bind_int64(stmt, 1, symbol_key);
+        sqlite3_bind_int64(stmt, 2, tick.timestamp_ms);
+        sqlite3_bind_int64(stmt, 3, tick.trade_id);
+        rc = sqlite3_step(stmt);
+        if (rc == SQLITE_ROW) {
+            tick.flags |= TICK_ALREADY_STORED;
+            ++stored;
+        } else if (rc != SQLITE_DONE) {
+            break;
+        }
+    }
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE && rc != SQLITE_ROW) {
+        cerr << "Replay lookup failed: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
+        return false;
+    }
+    return true;
+}
+
+static const char* JOURNAL_STATE_SQL =
+    "CREATE TABLE IF NOT EXISTS journal_state (id INTEGER PRIMARY KEY CHECK (id = 0), "
+    "committed_sequence INTEGER NOT NULL);";
+
+bool PersistenceManager::load_journal_watermark(uint64_t& sequence) {
+    sequence = 0;
+    if (!execute_sql(JOURNAL_STATE_SQL)) return false;
+
+    sqlite3_stmt* stmt;
+    const char* sql = "SELECT committed_sequence FROM journal_state WHERE id = 0;";
+    if (sqlite3_prepare_v2((sqlite3*)db_handle, sql, -1, &stmt, 0) != SQLITE_OK) {
+        cerr << "SQL error on prepare: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
+        return false;
+    }
+    int rc = sqlite3_step(stmt);
+    if (rc == SQLITE_ROW) sequence = (uint64_t)sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_ROW || rc == SQLITE_DONE;
+}
+
+bool PersistenceManager::save_journal_watermark(uint64_t sequence) {
+    if (!execute_sql(JOURNAL_STATE_SQL)) return false;
+
+    sqlite3_stmt* stmt;
+    const char* sql = "INSERT OR REPLACE INTO journal_state (id, committed_sequence) VALUES (0, ?);";
+    if (sqlite3_prepare_v2((sqlite3*)db_handle, sql, -1, &stmt, 0) != SQLITE_OK) {
+        cerr << "SQL error on prepare: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
+        return false;
+    }
+    sqlite3_bind_int64(stmt, 1, (sqlite3_int64)sequence);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
     if (rc != SQLITE_DONE) {
-        cerr << "Metrics insertion failed: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
+        cerr << "Journal watermark update failed: " << sqlite3_errmsg((sqlite3*)db_handle) << endl;
         return false;
     }
     return true;
@@ -128,9 +878,18 @@ bool PersistenceManager::begin_transaction() {
 
 bool PersistenceManager::commit_transaction() {
     std::cout << "[DB] Committing transaction..." << std::endl;
-    return execute_sql("COMMIT;");
+    if (!execute_sql("COMMIT;")) return false;
+    lock_guard<mutex> lock(symbols_mutex_);
+    uncommitted_symbols_.clear();
+    return true;
 }
 
 bool PersistenceManager::rollback_transaction() {
+    {
+        lock_guard<mutex> lock(symbols_mutex_);
+        for (SymbolId id : uncommitted_symbols_) symbol_keys_[id] = 0;
+        uncommitted_symbols_.clear();
+    }
     return execute_sql("ROLLBACK;");
-}
\ No newline at end of file
+}
+
@@ -0,0 +1,117 @@
+#include "../include/PersistenceWriter.h"
+#include <iostream>
+
+using namespace std;
+
+PersistenceWriter::PersistenceWriter(PersistenceBackend& db_mgr, size_t max_in_flight)
+    : db_manager_(db_mgr), max_in_flight_(max_in_flight > 0 ? max_in_flight : 1) {}
+
+PersistenceWriter::~PersistenceWriter() {
+    stop_thread();
+}
+
+// --- Thread Control ---
+
+void PersistenceWriter::start_thread() {
+    if (!thread_.joinable()) {
+        running_ = true;
+        thread_ = std::thread(&PersistenceWriter::writer_loop, this);
+        cout << "Persistence writer thread started (max " << max_in_flight_ << " batches in flight)." << endl;
+    }
+}
+
+void PersistenceWriter::stop_thread() {
+    if (thread_.joinable()) {
+        {
+            lock_guard<mutex> lock(mutex_);
+            running_ = false;
+        }
+        has_work_.notify_all();
+        thread_.join();
+        cout << "Persistence writer thread stopped." << endl;
+    }
+}
+
+// --- Producer Side ---
+
+void PersistenceWriter::submit(WriteBatch&& batch) {
+    if (batch.raw.empty() && batch.metrics.empty() && batch.bars.empty() && batch.indicators.empty()) return;
+
+    unique_lock<mutex> lock(mutex_);
+    if (in_flight_ >= max_in_flight_) {
+        cout << "[WRITER] Backpressure: " << in_flight_ << " batches in flight, waiting for commit." << endl;
+        has_room_.wait(lock, [this] { return in_flight_ < max_in_flight_ || !running_; });
+    }
+    pending_.push_back(std::move(batch));
+    ++in_flight_;
+    lock.unlock();
+    has_work_.notify_one();
+}
+
+size_t PersistenceWriter::in_flight() {
+    lock_guard<mutex> lock(mutex_);
+    return in_flight_;
+}
+
+size_t PersistenceWriter::failed_groups() {
+    lock_guard<mutex> lock(mutex_);
+    return failed_groups_;
+}
+
+// --- Writer Loop ---
+
+bool PersistenceWriter::write_group(std::vector<WriteBatch>& group) {
+    if (!db_manager_.begin_transaction()) {
+        cerr << "FATAL: Could not start DB transaction." << endl;
+        return false;
+    }
+
+    size_t rows = 0;
+    size_t bars = 0;
+    for (const auto& batch : group) {
+        if (!db_manager_.insert_raw_batch(batch.raw) || !db_manager_.insert_metrics_batch(batch.metrics) ||
+            !db_manager_.insert_bars_batch(batch.bars) || !db_manager_.insert_indicator_batch(batch.indicators)) {
+            cerr << "ERROR: Batch insert failed. Rolling back " << group.size() << " batches." << endl;
+            db_manager_.rollback_transaction();
+            return false;
+        }
+        rows += batch.raw.size();
+        bars += batch.bars.size();
+    }
+
+    if (!db_manager_.commit_transaction()) {
+        cerr << "FATAL: Transaction commit failed. Rolling back." << endl;
+        db_manager_.rollback_transaction();
+        return false;
+    }
+    cout << "[BATCH] Successfully committed " << rows << " rows, " << bars << " bars (" << group.size() << " batches) to DB." << endl;
+    return true;
+}
+
+void PersistenceWriter::writer_loop() {
+    std::vector<WriteBatch> group;
+
+    while (true) {
+        {
+            unique_lock<mutex> lock(mutex_);
+            has_work_.wait(lock, [this] { return !pending_.empty() || !running_; });
+            if (pending_.empty() && !running_) break;
+
+            // Take everything queued since the last commit
+            while (!pending_.empty()) {
+                group.push_back(std::move(pending_.front()));
+                pending_.pop_front();
+            }
+        }
+
+        bool committed = write_group(group);
+
+        {
+            lock_guard<mutex> lock(mutex_);
+            in_flight_ -= group.size();
+            if (!committed) ++failed_groups_;
+        }
+        has_room_.notify_all();
+        group.clear();
+    }
+}
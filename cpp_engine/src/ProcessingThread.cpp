@@ -11,8 +11,9 @@ using namespace std;
 
 // --- Constructor / Destructor ---
 
-ProcessingThread::ProcessingThread(SafeQueue<TickerData>& queue, PersistenceManager& db_mgr)
-    : data_queue_(queue), db_manager_(db_mgr), running_(true) 
+ProcessingThread::ProcessingThread(SafeQueue<TickerData>& queue, PersistenceWriter& writer, const IndicatorRegistry& indicators,
+                                   size_t shard)
+    : data_queue_(queue), writer_(writer), shard_(shard), running_(true), processor_(indicators)
 {
     // C++ threadovi se pokreću u start_thread metodi
 }
@@ -27,58 +28,43 @@ void ProcessingThread::start_thread() {
     if (!thread_.joinable()) {
         running_ = true;
         thread_ = std::thread(&ProcessingThread::process_data_loop, this);
-        cout << "Processing thread started." << endl;
+        cout << "Processing thread started (shard " << shard_ << ")." << endl;
     }
 }
 
 void ProcessingThread::stop_thread() {
     if (thread_.joinable()) {
         running_ = false;
+        data_queue_.interrupt();
         thread_.join();
-        cout << "Processing thread stopped." << endl;
+        cout << "Processing thread stopped (shard " << shard_ << ")." << endl;
     }
 }
 
-// --- Helper: Iznos i upis batcha ---
+// --- Helper: compute metrics and hand the batch to the writer ---
 
 void ProcessingThread::process_and_insert_batch(const std::vector<TickerData>& batch) {
     if (batch.empty()) return;
 
-    if (!db_manager_.begin_transaction()) {
-        cerr << "FATAL: Could not start DB transaction." << endl;
-        return;
-    }
+    WriteBatch write_batch;
+    write_batch.raw.reserve(batch.size());
+    write_batch.metrics.reserve(batch.size());
 
-    int success_count = 0;
     for (const auto& data : batch) {
-        //  Insert Raw Data
-        if (db_manager_.insert_raw_data(data)) {
-            success_count++;
-
-            // Insert Aggregated Metrics (unchanged dummy calculation)
-            double dummy_vwap = (data.high + data.low) / 2.0;
-            double dummy_avg = (data.open + data.close) / 2.0;
-            double calculated_ema_20 = calculate_ema(data.close, EMA_PERIOD_20);
-            double calculated_ema_50 = calculate_ema(data.close, EMA_PERIOD_50);
-
-            db_manager_.insert_metrics(
-                data.timestamp_ms,
-                data.trade_id, 
-                data.symbol, 
-                dummy_vwap, 
-                dummy_avg,
-                calculated_ema_20,
-                calculated_ema_50
-            );
+        if (data.flags & TICK_ALREADY_STORED) {
+            // The bars this closes were written along with the trade that closed them
+            candles_.add(data, stored_bars_);
+            stored_bars_.clear();
+            processor_.warm_up(data, indicator_state_[data.symbol_id]);
+            continue;
         }
+        write_batch.raw.push_back(data);
+        candles_.add(data, write_batch.bars);
+        processor_.process(data, indicator_state_[data.symbol_id], write_batch);
     }
 
-    if (db_manager_.commit_transaction()) {
-        cout << "[BATCH] Successfully committed " << success_count << " rows to DB." << endl;
-    } else {
-        cerr << "FATAL: Transaction commit failed. Rolling back." << endl;
-        db_manager_.rollback_transaction();
-    }
+    // The writer thread owns the transaction; this only blocks under backpressure
+    writer_.submit(std::move(write_batch));
 }
 
 
@@ -86,59 +72,51 @@ void ProcessingThread::process_and_insert_batch(const std::vector<TickerData>& b
 
 void ProcessingThread::process_data_loop() {
     std::vector<TickerData> current_batch;
-    auto last_flush_time = std::chrono::steady_clock::now();
+    current_batch.reserve(BATCH_SIZE);
+    const auto flush_timeout = std::chrono::milliseconds(FLUSH_TIMEOUT_MS);
+    auto batch_started = std::chrono::steady_clock::now();
     
     while (running_) {
-        std::optional<TickerData> data_opt = data_queue_.try_pop(); 
-
-        if (data_opt.has_value()) {
-            current_batch.push_back(data_opt.value());
-            last_flush_time = std::chrono::steady_clock::now();
-
-            if (current_batch.size() >= BATCH_SIZE) {
-                process_and_insert_batch(current_batch); 
-                current_batch.clear();
-            }
-        } else {
-            if (!running_) {
-                if (!current_batch.empty()) {
-                    cout << "[SHUTDOWN FLUSH] Processing final batch of " << current_batch.size() << " items." << endl;
-                    process_and_insert_batch(current_batch);
-                }
-                break; 
-            }
+        // Block until data arrives or the partial batch is due for its timeout flush
+        bool was_empty = current_batch.empty();
+        auto deadline = was_empty ? std::chrono::steady_clock::now() + flush_timeout
+                                  : batch_started + flush_timeout;
+        size_t popped = data_queue_.pop_bulk(current_batch, BATCH_SIZE - current_batch.size(), deadline);
         auto now = std::chrono::steady_clock::now();
-            if (!current_batch.empty() && 
-                std::chrono::duration_cast<std::chrono::milliseconds>(now - last_flush_time).count() > 500) { // 500 ms timeout
-                
-                std::cout << "[TIMEOUT FLUSH] Processing final batch of " << current_batch.size() << " items due to timeout." << std::endl;
-                process_and_insert_batch(current_batch);
-                current_batch.clear();
-                last_flush_time = now;
-            }
-            
-            std::this_thread::sleep_for(std::chrono::milliseconds(100)); 
-        }
-    }
-}
 
-double ProcessingThread::calculate_ema(double current_price, int period) {
+        if (was_empty && popped > 0) {
+            batch_started = now;
+        }
 
-    double& last_ema_value = (period == EMA_PERIOD_20) ? last_ema_value_20_ : last_ema_value_50_;
-    bool& is_first_ema = (period == EMA_PERIOD_20) ? is_first_ema_20_ : is_first_ema_50_;
+        if (current_batch.size() >= BATCH_SIZE) {
+            process_and_insert_batch(current_batch); 
+            current_batch.clear();
+        } else if (!current_batch.empty() && now - batch_started >= flush_timeout) {
+            std::cout << "[TIMEOUT FLUSH] Shard " << shard_ << ": processing final batch of " << current_batch.size() << " items due to timeout." << std::endl;
+            process_and_insert_batch(current_batch);
+            current_batch.clear();
+        }
+    }
 
-    const double multiplier = 2.0 / (static_cast<double>(period) + 1.0);
-    
-    double new_ema;
-    
-    if (is_first_ema) {
-        new_ema = current_price;
-        is_first_ema = false;
-    } else {
-        new_ema = (current_price * multiplier) + (last_ema_value * (1.0 - multiplier));
+    // Drain whatever is still queued so nothing accepted by the ingestor is lost
+    auto no_wait = std::chrono::steady_clock::now();
+    while (data_queue_.pop_bulk(current_batch, BATCH_SIZE - current_batch.size(), no_wait) > 0) {
+        if (current_batch.size() >= BATCH_SIZE) {
+            process_and_insert_batch(current_batch);
+            current_batch.clear();
+        }
+    }
+    if (!current_batch.empty()) {
+        cout << "[SHUTDOWN FLUSH] Shard " << shard_ << ": processing final batch of " << current_batch.size() << " items." << endl;
+        process_and_insert_batch(current_batch);
     }
 
-    last_ema_value = new_ema;
-    
-    return new_ema;
-}
\ No newline at end of file
+    // Bars still open have no closing trade yet; persist them as partial bars
+    WriteBatch open_bars;
+    candles_.flush(open_bars.bars);
+    if (!open_bars.bars.empty()) {
+        cout << "[SHUTDOWN FLUSH] Shard " << shard_ << ": writing " << open_bars.bars.size() << " open bars ("
+             << candles_.late_trades() << " late trades skipped)." << endl;
+        writer_.submit(std::move(open_bars));
+    }
+}
@@ -0,0 +1,326 @@
+#include "../include/RetentionCompactor.h"
+#include "../include/PartitionedDatabase.h"
+#include "../include/UtcTime.h"
+#include "../include/sqlite3.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const long long NO_CUTOFF = LLONG_MIN;
+
+static const char* RETENTION_STATE_SQL =
+    "CREATE TABLE IF NOT EXISTS retention_state (name TEXT PRIMARY KEY, done_before_ms INTEGER NOT NULL);"
+    "CREATE TEMP TABLE IF NOT EXISTS retention_drop (symbol_id INTEGER NOT NULL, open_time_ms INTEGER NOT NULL,"
+    " trade_id INTEGER NOT NULL);";
+
+// Work goes one symbol at a time, so every statement reads or deletes one key range:
+// ?1 = symbol_id, [?2, ?3) = time range, ?4 = bucket width
+
+// Open and close follow (open_time_ms, trade_id) like the live CandleAggregator; bars it
+// already wrote are kept as they are
+static const char* ROLLUP_TICKS_SQL =
+    "INSERT OR IGNORE INTO ohlcv_bars (symbol_id, interval_ms, open_time_ms, open_price, high_price, low_price,"
+    " close_price, volume, quote_volume, trade_count) "
+    "SELECT ?1, ?4, bucket, first_price, max(close_price), min(close_price), last_price, sum(volume),"
+    " sum(close_price * volume), count(*) FROM ("
+    "  SELECT close_price, volume, open_time_ms - open_time_ms % ?4 AS bucket,"
+    "   first_value(close_price) OVER bucket_trades AS first_price, last_value(close_price) OVER bucket_trades AS last_price"
+    "  FROM raw_ohlcv_data WHERE symbol_id = ?1 AND open_time_ms >= ?2 AND open_time_ms < ?3"
+    "  WINDOW bucket_trades AS (PARTITION BY open_time_ms - open_time_ms % ?4 ORDER BY open_time_ms, trade_id"
+    "   ROWS BETWEEN UNBOUNDED PRECEDING AND UNBOUNDED FOLLOWING))"
+    " GROUP BY bucket;";
+static const char* DELETE_TICKS_SQL =
+    "DELETE FROM raw_ohlcv_data WHERE symbol_id = ?1 AND open_time_ms >= ?2 AND open_time_ms < ?3;";
+
+// Every metrics row but the last of its bucket
+static const char* SELECT_THINNED_SQL =
+    "INSERT INTO temp.retention_drop SELECT ?1, open_time_ms, trade_id FROM ("
+    " SELECT open_time_ms, trade_id, row_number() OVER (PARTITION BY open_time_ms - open_time_ms % ?4"
+    "  ORDER BY open_time_ms DESC, trade_id DESC) AS newest"
+    " FROM aggregated_metrics WHERE symbol_id = ?1 AND open_time_ms >= ?2 AND open_time_ms < ?3) WHERE newest > 1;";
+static const char* DELETE_METRICS_SQL =
+    "DELETE FROM aggregated_metrics WHERE (symbol_id, open_time_ms, trade_id) IN "
+    "(SELECT symbol_id, open_time_ms, trade_id FROM temp.retention_drop);";
+static const char* DELETE_INDICATORS_SQL =
+    "DELETE FROM indicator_values WHERE (symbol_id, open_time_ms, trade_id) IN "
+    "(SELECT symbol_id, open_time_ms, trade_id FROM temp.retention_drop);";
+static const char* SAVE_WATERMARK_SQL =
+    "INSERT OR REPLACE INTO retention_state (name, done_before_ms) VALUES ('aggregated_metrics', ?1);";
+
+RetentionCompactor::RetentionCompactor(const RetentionPolicy& policy, const std::string& db_path,
+                                       const PartitionedDatabase* partitioned)
+    : policy_(policy), db_path_(db_path), partitioned_(partitioned) {}
+
+RetentionCompactor::~RetentionCompactor() {
+    stop();
+}
+
+void RetentionCompactor::start() {
+    stop_ = false;
+    thread_ = std::thread(&RetentionCompactor::compactor_loop, this);
+}
+
+void RetentionCompactor::stop() {
+    if (!thread_.joinable()) return;
+    {
+        lock_guard<mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+bool RetentionCompactor::stopping() {
+    lock_guard<mutex> lock(mutex_);
+    return stop_;
+}
+
+void RetentionCompactor::compactor_loop() {
+    unique_lock<mutex> lock(mutex_);
+    while (!stop_) {
+        lock.unlock();
+        RetentionStats stats;
+        run_once(stats);
+        lock.lock();
+        cv_.wait_for(lock, chrono::milliseconds(policy_.interval_ms), [this] { return stop_; });
+    }
+}
+
+bool RetentionCompactor::run_once(RetentionStats& stats) {
+    auto started = chrono::steady_clock::now();
+    long long now_ms = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+    long long tick_cutoff = policy_.tick_retention_ms > 0
+                                ? floor_to_interval(now_ms - policy_.tick_retention_ms, RETENTION_BAR_INTERVAL_MS)
+                                : NO_CUTOFF;
+    long long metric_cutoff = policy_.metric_retention_ms > 0
+                                  ? floor_to_interval(now_ms - policy_.metric_retention_ms, policy_.metric_resolution_ms)
+                                  : NO_CUTOFF;
+
+    bool ok = true;
+    if (partitioned_) {
+        // A partition is done for good once every enabled cutoff has passed its end
+        long long latest = max(tick_cutoff, metric_cutoff);
+        long long expired_before = tick_cutoff == NO_CUTOFF ? metric_cutoff
+                                   : metric_cutoff == NO_CUTOFF ? tick_cutoff
+                                                                : min(tick_cutoff, metric_cutoff);
+        for (const DbPartition& partition : partitioned_->partitions(NO_CUTOFF, latest - 1)) {
+            if (stopping()) break;
+            bool expired = partition.start_ms + partitioned_->interval_ms() <= expired_before;
+            ok = compact_file(partition.path, tick_cutoff, metric_cutoff, expired, stats) && ok;
+        }
+    } else {
+        ok = compact_file(db_path_, tick_cutoff, metric_cutoff, false, stats);
+    }
+
+    if (stats.chunks > 0) {
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        cout << "[RETENTION] " << stats.trades_deleted << " trades deleted (" << stats.bars_added
+             << " missing 1m bars rebuilt), " << stats.metrics_deleted << " metric rows and "
+             << stats.indicator_values_deleted << " indicator values thinned to " << policy_.metric_resolution_ms / 1000
+             << " s; " << fixed << setprecision(1) << stats.bytes_freed / 1048576.0 << " MB freed, "
+             << stats.bytes_returned / 1048576.0 << " MB returned to the OS; " << stats.chunks << " chunks in "
+             << setprecision(2) << seconds << " s" << defaultfloat << endl;
+    }
+    return ok;
+}
+
+// --- One database file ---
+
+static uint64_t file_bytes(const std::string& path) {
+    error_code ec;
+    uint64_t bytes = 0;
+    for (const char* suffix : {"", "-wal"}) {
+        uintmax_t size = fs::file_size(path + suffix, ec);
+        if (!ec) bytes += size;
+    }
+    return bytes;
+}
+
+// First column of a one-row query; false if there is no row or it is NULL
+static bool query_int64(sqlite3* db, const char* sql, long long& value, long long bind1 = 0, long long bind2 = 0,
+                        long long bind3 = 0) {
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, 0) != SQLITE_OK) {
+        cerr << "[RETENTION] SQL error on prepare: " << sqlite3_errmsg(db) << endl;
+        return false;
+    }
+    long long binds[3] = {bind1, bind2, bind3};
+    for (int i = 0; i < sqlite3_bind_parameter_count(stmt) && i < 3; ++i) sqlite3_bind_int64(stmt, i + 1, binds[i]);
+    bool found = sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL;
+    if (found) value = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+// Runs a prepared statement with as many of (symbol, from, to, bucket) as it takes; -1 on
+// failure, else the rows changed
+static long long run_range(sqlite3* db, sqlite3_stmt* stmt, long long symbol_id = 0, long long from_ms = 0,
+                           long long to_ms = 0, long long bucket_ms = 0) {
+    sqlite3_reset(stmt);
+    long long binds[4] = {symbol_id, from_ms, to_ms, bucket_ms};
+    for (int i = 0; i < sqlite3_bind_parameter_count(stmt) && i < 4; ++i) sqlite3_bind_int64(stmt, i + 1, binds[i]);
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        cerr << "[RETENTION] " << sqlite3_errmsg(db) << endl;
+        return -1;
+    }
+    return sqlite3_changes(db);
+}
+
+// End of a chunk of `symbol_id` starting at `from_ms`: about `rows` rows of `table` later,
+// rounded down to whole buckets (at least one), and never past `cutoff_ms`
+static long long chunk_end(sqlite3* db, const string& table, long long symbol_id, long long from_ms, long long cutoff_ms,
+                           long long bucket_ms, size_t rows) {
+    string sql = "SELECT open_time_ms FROM " + table +
+                 " WHERE symbol_id = ?1 AND open_time_ms >= ?2 ORDER BY open_time_ms LIMIT 1 OFFSET ?3;";
+    long long timestamp;
+    if (!query_int64(db, sql.c_str(), timestamp, symbol_id, from_ms, (long long)rows)) return cutoff_ms;
+    long long end = max(floor_to_interval(timestamp, bucket_ms), from_ms + bucket_ms);
+    return min(end, cutoff_ms);
+}
+
+bool RetentionCompactor::compact_file(const std::string& path, long long tick_cutoff_ms, long long metric_cutoff_ms,
+                                      bool vacuum, RetentionStats& stats) {
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READWRITE, nullptr) != SQLITE_OK) {
+        cerr << "[RETENTION] Can't open " << path << ": " << sqlite3_errmsg(db) << endl;
+        sqlite3_close(db);
+        return false;
+    }
+    sqlite3_busy_timeout(db, DbConfig().busy_timeout_ms);
+    uint64_t bytes_before = file_bytes(path);
+    long long page_size = 0, auto_vacuum = 0;
+    query_int64(db, "PRAGMA page_size;", page_size);
+    query_int64(db, "PRAGMA auto_vacuum;", auto_vacuum);
+
+    const char* sql[] = {ROLLUP_TICKS_SQL, DELETE_TICKS_SQL, SELECT_THINNED_SQL, DELETE_METRICS_SQL,
+                         DELETE_INDICATORS_SQL, SAVE_WATERMARK_SQL};
+    const size_t statement_count = sizeof(sql) / sizeof(sql[0]);
+    sqlite3_stmt* stmts[statement_count] = {};
+    bool ok = sqlite3_exec(db, RETENTION_STATE_SQL, 0, 0, 0) == SQLITE_OK;
+    for (size_t i = 0; ok && i < statement_count; ++i) {
+        ok = sqlite3_prepare_v2(db, sql[i], -1, &stmts[i], 0) == SQLITE_OK;
+    }
+    if (!ok) cerr << "[RETENTION] " << path << ": " << sqlite3_errmsg(db) << endl;
+    sqlite3_stmt *rollup = stmts[0], *delete_ticks = stmts[1], *select_thinned = stmts[2], *delete_metrics = stmts[3],
+                 *delete_indicators = stmts[4], *save_watermark = stmts[5];
+
+    // Each chunk takes the write lock up front and holds it for one bounded transaction
+    size_t chunks_before = stats.chunks;
+    auto run_chunk = [&](auto&& body) {
+        if (sqlite3_exec(db, "BEGIN IMMEDIATE;", 0, 0, 0) != SQLITE_OK) {
+            cerr << "[RETENTION] " << path << ": " << sqlite3_errmsg(db) << endl;
+            return false;
+        }
+        long long free_before = 0, free_after = 0;
+        query_int64(db, "PRAGMA freelist_count;", free_before);
+        bool done = body();
+        query_int64(db, "PRAGMA freelist_count;", free_after);
+        if (done && auto_vacuum == 2) {
+            done = sqlite3_exec(db, "PRAGMA incremental_vacuum;", 0, 0, 0) == SQLITE_OK;
+        }
+        if (!done || sqlite3_exec(db, "COMMIT;", 0, 0, 0) != SQLITE_OK) {
+            cerr << "[RETENTION] Chunk rolled back in " << path << ": " << sqlite3_errmsg(db) << endl;
+            sqlite3_exec(db, "ROLLBACK;", 0, 0, 0);
+            return false;
+        }
+        if (free_after > free_before) stats.bytes_freed += (uint64_t)((free_after - free_before) * page_size);
+        ++stats.chunks;
+
+        lock_guard<mutex> lock(mutex_);
+        return !stop_;
+    };
+    auto pause = [&] {
+        unique_lock<mutex> lock(mutex_);
+        cv_.wait_for(lock, chrono::milliseconds(policy_.chunk_pause_ms), [this] { return stop_; });
+    };
+
+    // Symbols present in `table`, in id order (a skip scan over the leading key column)
+    auto next_symbol = [&](const char* table, long long& symbol_id) {
+        string sql = string("SELECT min(symbol_id) FROM ") + table + " WHERE symbol_id > ?1;";
+        return ok && !stopping() && query_int64(db, sql.c_str(), symbol_id, symbol_id);
+    };
+
+    // Expired trades, oldest bucket first; deleting them moves the start along
+    long long symbol_id = LLONG_MIN, from_ms;
+    while (tick_cutoff_ms != NO_CUTOFF && next_symbol("raw_ohlcv_data", symbol_id)) {
+        while (query_int64(db, "SELECT min(open_time_ms) FROM raw_ohlcv_data WHERE symbol_id = ?1;", from_ms, symbol_id) &&
+               from_ms < tick_cutoff_ms) {
+            from_ms = floor_to_interval(from_ms, RETENTION_BAR_INTERVAL_MS);
+            long long to_ms = chunk_end(db, "raw_ohlcv_data", symbol_id, from_ms, tick_cutoff_ms, RETENTION_BAR_INTERVAL_MS,
+                                        policy_.chunk_rows);
+            bool more = run_chunk([&] {
+                long long bars = run_range(db, rollup, symbol_id, from_ms, to_ms, RETENTION_BAR_INTERVAL_MS);
+                long long trades = bars < 0 ? -1 : run_range(db, delete_ticks, symbol_id, from_ms, to_ms);
+                if (trades < 0) return false;
+                stats.bars_added += bars;
+                stats.trades_deleted += trades;
+                return true;
+            });
+            if (!more) {
+                ok = stopping();
+                break;
+            }
+            pause();
+        }
+    }
+
+    // Metrics from the file's watermark on (each symbol's oldest row on the first pass)
+    long long watermark = LLONG_MIN;
+    query_int64(db, "SELECT done_before_ms FROM retention_state WHERE name = 'aggregated_metrics';", watermark);
+    size_t metric_chunks = 0;
+    symbol_id = LLONG_MIN;
+    while (metric_cutoff_ms != NO_CUTOFF && watermark < metric_cutoff_ms && next_symbol("aggregated_metrics", symbol_id)) {
+        long long next_ms;
+        from_ms = watermark;
+        while (query_int64(db, "SELECT min(open_time_ms) FROM aggregated_metrics WHERE symbol_id = ?1 AND open_time_ms >= ?2;",
+                           next_ms, symbol_id, from_ms) &&
+               next_ms < metric_cutoff_ms) {
+            // Skip gaps without an empty transaction
+            from_ms = floor_to_interval(max(from_ms, next_ms), policy_.metric_resolution_ms);
+            long long to_ms = chunk_end(db, "aggregated_metrics", symbol_id, from_ms, metric_cutoff_ms,
+                                        policy_.metric_resolution_ms, policy_.chunk_rows);
+            bool more = run_chunk([&] {
+                if (sqlite3_exec(db, "DELETE FROM temp.retention_drop;", 0, 0, 0) != SQLITE_OK ||
+                    run_range(db, select_thinned, symbol_id, from_ms, to_ms, policy_.metric_resolution_ms) < 0) {
+                    return false;
+                }
+                long long metrics = run_range(db, delete_metrics);
+                long long values = metrics < 0 ? -1 : run_range(db, delete_indicators);
+                if (values < 0) return false;
+                stats.metrics_deleted += metrics;
+                stats.indicator_values_deleted += values;
+                return true;
+            });
+            if (!more) {
+                ok = stopping();
+                break;
+            }
+            ++metric_chunks;
+            from_ms = to_ms;
+            pause();
+        }
+    }
+    // Only once every symbol is done; an interrupted pass starts over (thinning twice is harmless)
+    if (ok && metric_chunks > 0 && !stopping() && run_range(db, save_watermark, metric_cutoff_ms) < 0) ok = false;
+
+    for (sqlite3_stmt* stmt : stmts) sqlite3_finalize(stmt);
+
+    // An expired partition gets no more writes, so rewriting it blocks nobody
+    if (ok && vacuum && stats.chunks > chunks_before && !stopping()) {
+        if (sqlite3_exec(db, "VACUUM;", 0, 0, 0) != SQLITE_OK ||
+            sqlite3_exec(db, "PRAGMA wal_checkpoint(TRUNCATE);", 0, 0, 0) != SQLITE_OK) {
+            cerr << "[RETENTION] VACUUM of " << path << " failed: " << sqlite3_errmsg(db) << endl;
+        }
+    }
+    sqlite3_close(db);
+
+    uint64_t bytes_after = file_bytes(path);
+    if (bytes_after < bytes_before) stats.bytes_returned += bytes_before - bytes_after;
+    return ok;
+}
@@ -0,0 +1,35 @@
+#include "../include/SymbolTable.h"
+#include <iostream>
+
+using namespace std;
+
+SymbolTable::SymbolTable() : names_(new string[MAX_SYMBOLS]) {}
+
+SymbolTable& SymbolTable::instance() {
+    static SymbolTable table;
+    return table;
+}
+
+SymbolId SymbolTable::intern(string_view symbol) {
+    lock_guard<mutex> lock(mutex_);
+
+    auto it = ids_.find(symbol);
+    if (it != ids_.end()) return it->second;
+
+    size_t id = count_.load(std::memory_order_relaxed);
+    if (id >= MAX_SYMBOLS) {
+        cerr << "FATAL: symbol table full (" << MAX_SYMBOLS << "), cannot intern " << symbol << endl;
+        return INVALID_SYMBOL;
+    }
+
+    names_[id].assign(symbol.data(), symbol.size());
+    ids_.emplace(string_view(names_[id]), static_cast<SymbolId>(id));
+    count_.store(id + 1, std::memory_order_release); // Publishes names_[id] to name()
+    return static_cast<SymbolId>(id);
+}
+
+SymbolId SymbolTable::find(string_view symbol) {
+    lock_guard<mutex> lock(mutex_);
+    auto it = ids_.find(symbol);
+    return it != ids_.end() ? it->second : INVALID_SYMBOL;
+}
@@ -0,0 +1,317 @@
+#include "../include/TickCodec.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+using namespace std;
+
+static const int MAX_FIXED_POINT_DECIMALS = 15;
+static const double POW10[MAX_FIXED_POINT_DECIMALS + 1] = {1e0, 1e1, 1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                                           1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+static const double MAX_EXACT_INTEGER = 9007199254740992.0; // 2^53
+
+// Delta-of-delta buckets: a run of k one-bits (k < 5, then a zero; or five ones) selects
+// the payload width DOD_WIDTHS[k]
+static const unsigned DOD_WIDTHS[6] = {0, 7, 9, 12, 32, 64};
+
+namespace {
+
+inline unsigned leading_zeros(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return 63 - index;
+#else
+    return __builtin_clzll(x);
+#endif
+}
+
+inline unsigned trailing_zeros(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return index;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+inline uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t z) {
+    return static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+}
+
+inline uint64_t double_bits(double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+inline uint64_t low_mask(unsigned bits) {
+    return bits >= 64 ? ~0ULL : (1ULL << bits) - 1;
+}
+
+// LSB-first bit stream appended to a byte vector
+class BitWriter {
+private:
+    vector<uint8_t>& out_;
+    uint64_t acc_ = 0;
+    unsigned used_ = 0;
+
+    void emit(uint64_t word, unsigned bytes) {
+        for (unsigned i = 0; i < bytes; ++i) out_.push_back(static_cast<uint8_t>(word >> (8 * i)));
+    }
+
+public:
+    explicit BitWriter(vector<uint8_t>& out) : out_(out) {}
+
+    void write(uint64_t value, unsigned bits) {
+        if (bits == 0) return;
+        value &= low_mask(bits);
+        acc_ |= value << used_;
+        if (used_ + bits >= 64) {
+            emit(acc_, 8);
+            unsigned taken = 64 - used_;
+            acc_ = taken < 64 ? value >> taken : 0;
+            used_ = used_ + bits - 64;
+        } else {
+            used_ += bits;
+        }
+    }
+
+    void flush() {
+        emit(acc_, (used_ + 7) / 8);
+        acc_ = 0;
+        used_ = 0;
+    }
+};
+
+// Reads whole 64-bit words (little-endian), hence the 8 bytes of padding after a stream
+class BitReader {
+private:
+    const uint8_t* data_;
+    size_t pos_ = 0; // In bits
+
+public:
+    explicit BitReader(const uint8_t* data) : data_(data) {}
+
+    // Up to 57 bits without advancing
+    uint64_t peek(unsigned bits) const {
+        uint64_t word;
+        memcpy(&word, data_ + (pos_ >> 3), sizeof(word));
+        return (word >> (pos_ & 7)) & low_mask(bits);
+    }
+
+    void skip(unsigned bits) { pos_ += bits; }
+
+    uint64_t read(unsigned bits) {
+        if (bits > 56) {
+            uint64_t low = peek(32);
+            pos_ += 32;
+            return low | (read(bits - 32) << 32);
+        }
+        uint64_t value = peek(bits);
+        pos_ += bits;
+        return value;
+    }
+
+    size_t bytes() const { return (pos_ + 7) / 8; }
+};
+
+size_t decode_delta_delta(const uint8_t* in, size_t n, long long* out) {
+    BitReader reader(in);
+    if (n == 0) return 0;
+    int64_t value = static_cast<int64_t>(reader.read(64));
+    uint64_t delta = 0;
+    out[0] = value;
+    for (size_t i = 1; i < n; ++i) {
+        uint64_t prefix = reader.peek(5);
+        unsigned ones = 0;
+        while (ones < 5 && (prefix >> ones) & 1) ++ones;
+        reader.skip(ones < 5 ? ones + 1 : 5);
+        unsigned width = DOD_WIDTHS[ones];
+        if (width > 0) delta += static_cast<uint64_t>(unzigzag(reader.read(width)));
+        value = static_cast<int64_t>(static_cast<uint64_t>(value) + delta);
+        out[i] = value;
+    }
+    return reader.bytes();
+}
+
+size_t decode_xor(const uint8_t* in, size_t n, double* out) {
+    BitReader reader(in);
+    if (n == 0) return 0;
+    uint64_t bits = reader.read(64);
+    unsigned leading = 0, meaningful = 64;
+    memcpy(&out[0], &bits, sizeof(bits));
+    for (size_t i = 1; i < n; ++i) {
+        if (reader.read(1)) {
+            if (reader.read(1)) {
+                leading = static_cast<unsigned>(reader.read(5));
+                meaningful = static_cast<unsigned>(reader.read(6)) + 1;
+            }
+            bits ^= reader.read(meaningful) << (64 - leading - meaningful);
+        }
+        memcpy(&out[i], &bits, sizeof(bits));
+    }
+    return reader.bytes();
+}
+
+size_t decode_fixed_point(const uint8_t* in, size_t n, double* out) {
+    int decimals = in[0];
+    if (decimals > MAX_FIXED_POINT_DECIMALS) return 0;
+    BitReader reader(in + 1);
+    if (n == 0) return 1;
+    int64_t value = static_cast<int64_t>(reader.read(64));
+    unsigned width = static_cast<unsigned>(reader.read(7));
+    const double scale = POW10[decimals];
+    out[0] = static_cast<double>(value) / scale;
+    for (size_t i = 1; i < n; ++i) {
+        value += unzigzag(reader.read(width));
+        out[i] = static_cast<double>(value) / scale;
+    }
+    return 1 + reader.bytes();
+}
+
+} // namespace
+
+// --- Encoders ---
+
+void encode_delta_delta(const long long* values, size_t n, std::vector<uint8_t>& out) {
+    out.push_back(TICK_CODEC_DELTA_DELTA);
+    BitWriter writer(out);
+    if (n > 0) {
+        writer.write(static_cast<uint64_t>(values[0]), 64);
+        uint64_t previous_delta = 0;
+        for (size_t i = 1; i < n; ++i) {
+            // Unsigned arithmetic: wraps instead of overflowing, and decodes back exactly
+            uint64_t delta = static_cast<uint64_t>(values[i]) - static_cast<uint64_t>(values[i - 1]);
+            uint64_t z = zigzag(static_cast<int64_t>(delta - previous_delta));
+            previous_delta = delta;
+            if (z == 0) {
+                writer.write(0, 1);
+            } else if (z < (1ULL << 7)) {
+                writer.write(0x1, 2);
+                writer.write(z, 7);
+            } else if (z < (1ULL << 9)) {
+                writer.write(0x3, 3);
+                writer.write(z, 9);
+            } else if (z < (1ULL << 12)) {
+                writer.write(0x7, 4);
+                writer.write(z, 12);
+            } else if (z < (1ULL << 32)) {
+                writer.write(0xF, 5);
+                writer.write(z, 32);
+            } else {
+                writer.write(0x1F, 5);
+                writer.write(z, 64);
+            }
+        }
+    }
+    writer.flush();
+}
+
+void encode_xor(const double* values, size_t n, std::vector<uint8_t>& out) {
+    out.push_back(TICK_CODEC_XOR);
+    BitWriter writer(out);
+    if (n > 0) {
+        uint64_t previous = double_bits(values[0]);
+        writer.write(previous, 64);
+        unsigned leading = 65, trailing = 0; // No window yet
+        for (size_t i = 1; i < n; ++i) {
+            uint64_t bits = double_bits(values[i]);
+            uint64_t x = bits ^ previous;
+            previous = bits;
+            if (x == 0) {
+                writer.write(0, 1);
+                continue;
+            }
+            unsigned lz = leading_zeros(x);
+            if (lz > 31) lz = 31; // Fits the 5-bit field
+            unsigned tz = trailing_zeros(x);
+            if (leading <= 64 && lz >= leading && tz >= trailing) {
+                // Same window as the previous value
+                writer.write(0x1, 2);
+                writer.write(x >> trailing, 64 - leading - trailing);
+            } else {
+                unsigned meaningful = 64 - lz - tz;
+                writer.write(0x3, 2);
+                writer.write(lz, 5);
+                writer.write(meaningful - 1, 6);
+                writer.write(x >> tz, meaningful);
+                leading = lz;
+                trailing = tz;
+            }
+        }
+    }
+    writer.flush();
+}
+
+bool encode_fixed_point(const double* values, size_t n, int max_decimals, std::vector<uint8_t>& out) {
+    if (max_decimals > MAX_FIXED_POINT_DECIMALS) max_decimals = MAX_FIXED_POINT_DECIMALS;
+
+    std::vector<int64_t> scaled(n);
+    int decimals = -1;
+    for (int d = 0; d <= max_decimals && decimals < 0; ++d) {
+        bool exact = true;
+        for (size_t i = 0; i < n && exact; ++i) {
+            double s = values[i] * POW10[d];
+            if (!(std::fabs(s) < MAX_EXACT_INTEGER)) {
+                exact = false;
+                break;
+            }
+            scaled[i] = std::llround(s);
+            // Bit-for-bit, so -0.0 and NaN fall back to another codec
+            exact = double_bits(static_cast<double>(scaled[i]) / POW10[d]) == double_bits(values[i]);
+        }
+        if (exact) decimals = d;
+    }
+    if (decimals < 0) return false;
+
+    unsigned width = 0;
+    for (size_t i = 1; i < n; ++i) {
+        uint64_t z = zigzag(scaled[i] - scaled[i - 1]);
+        if (z != 0) width = std::max(width, 64 - leading_zeros(z));
+    }
+
+    out.push_back(TICK_CODEC_FIXED_POINT);
+    out.push_back(static_cast<uint8_t>(decimals));
+    BitWriter writer(out);
+    if (n > 0) {
+        writer.write(static_cast<uint64_t>(scaled[0]), 64);
+        writer.write(width, 7);
+        for (size_t i = 1; i < n; ++i) writer.write(zigzag(scaled[i] - scaled[i - 1]), width);
+    }
+    writer.flush();
+    return true;
+}
+
+// --- Decoder ---
+
+size_t decode_column(const uint8_t* in, size_t n, void* out) {
+    size_t used;
+    switch (in[0]) {
+    case TICK_CODEC_RAW:
+        memcpy(out, in + 1, n * 8);
+        return 1 + n * 8;
+    case TICK_CODEC_DELTA_DELTA:
+        used = decode_delta_delta(in + 1, n, static_cast<long long*>(out));
+        break;
+    case TICK_CODEC_XOR:
+        used = decode_xor(in + 1, n, static_cast<double*>(out));
+        break;
+    case TICK_CODEC_FIXED_POINT:
+        used = decode_fixed_point(in + 1, n, static_cast<double*>(out));
+        if (used == 0) return 0;
+        break;
+    default:
+        return 0;
+    }
+    return 1 + used;
+}
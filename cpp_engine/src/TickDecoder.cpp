@@ -0,0 +1,247 @@
+#include "../include/TickDecoder.h"
+#include "../include/CpuFeatures.h"
+#include <cstring>
+
+#ifdef ENGINE_X86
+    #include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+inline unsigned trailing_zeros(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// --- Delimiter index kernels: append the offset of every ',' and '\n' in [begin, end) ---
+
+void index_scalar(const char* data, size_t begin, size_t end, vector<uint32_t>& out) {
+    for (size_t i = begin; i < end; ++i) {
+        if (data[i] == ',' || data[i] == '\n') out.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+inline void emit_mask(uint32_t mask, size_t base, vector<uint32_t>& out) {
+    while (mask) {
+        out.push_back(static_cast<uint32_t>(base + trailing_zeros(mask)));
+        mask &= mask - 1;
+    }
+}
+
+#ifdef ENGINE_X86
+
+ENGINE_TARGET("sse2")
+void index_sse2(const char* data, size_t size, vector<uint32_t>& out) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, comma), _mm_cmpeq_epi8(chunk, newline));
+        emit_mask(static_cast<uint32_t>(_mm_movemask_epi8(hits)), i, out);
+    }
+    index_scalar(data, i, size, out);
+}
+
+ENGINE_TARGET("avx2")
+void index_avx2(const char* data, size_t size, vector<uint32_t>& out) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, comma), _mm256_cmpeq_epi8(chunk, newline));
+        emit_mask(static_cast<uint32_t>(_mm256_movemask_epi8(hits)), i, out);
+    }
+    index_scalar(data, i, size, out);
+}
+
+#endif // ENGINE_X86
+
+// --- Digit kernels ---
+
+// Eight ASCII digits -> integer; false if any byte is not a digit
+inline bool parse_eight_digits(const char* p, uint64_t& value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) {
+        unsigned d = static_cast<unsigned char>(p[i]) - '0';
+        if (d > 9) return false;
+        v = v * 10 + d;
+    }
+    value = v;
+    return true;
+#else
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    if (((v & 0xF0F0F0F0F0F0F0F0ULL) | (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4))
+            != 0x3333333333333333ULL) {
+        return false;
+    }
+    // SWAR reduction: pairs -> quads -> octet (little-endian byte order)
+    v -= 0x3030303030303030ULL;
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+         (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    value = static_cast<uint32_t>(v);
+    return true;
+#endif
+}
+
+inline bool parse_uint(const char* p, const char* end, long long& value) {
+    size_t len = end - p;
+    if (len == 0 || len > 18) return false;
+    long long v = 0;
+    for (; p < end; ++p) {
+        unsigned d = static_cast<unsigned char>(*p) - '0';
+        if (d > 9) return false;
+        v = v * 10 + d;
+    }
+    value = v;
+    return true;
+}
+
+/**
+ * Decodes "<digits>.<8 digits>" exactly. The scaled mantissa is an exact integer below
+ * 2^53 and 1e8 is exact, so the single correctly-rounded division yields the same
+ * double as from_chars/strtod would.
+ */
+inline bool parse_fixed8(const char* p, const char* end, double& value) {
+    size_t len = end - p;
+    if (len < 10 || len > 17) return false;
+    const char* dot = end - 9;
+    if (*dot != '.') return false;
+
+    uint64_t int_part = 0;
+    for (const char* c = p; c < dot; ++c) {
+        unsigned d = static_cast<unsigned char>(*c) - '0';
+        if (d > 9) return false;
+        int_part = int_part * 10 + d;
+    }
+    uint64_t frac;
+    if (!parse_eight_digits(dot + 1, frac)) return false;
+
+    uint64_t mantissa = int_part * 100000000ULL + frac;
+    if (mantissa > (1ULL << 53)) return false;
+    value = static_cast<double>(mantissa) / 1e8;
+    return true;
+}
+
+} // namespace
+
+// --- TickDecoder ---
+
+TickDecoder::TickDecoder() : kernel_(Kernel::Scalar) {
+    const CpuFeatures& cpu = cpu_features();
+    if (cpu.avx2) {
+        kernel_ = Kernel::AVX2;
+    } else if (cpu.sse2) {
+        kernel_ = Kernel::SSE2;
+    }
+}
+
+const char* TickDecoder::kernel_name(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar: return "scalar";
+        case Kernel::SSE2:   return "sse2";
+        case Kernel::AVX2:   return "avx2";
+    }
+    return "unknown";
+}
+
+void TickDecoder::set_kernel(Kernel kernel) {
+    const CpuFeatures& cpu = cpu_features();
+    if ((kernel == Kernel::AVX2 && !cpu.avx2) || (kernel == Kernel::SSE2 && !cpu.sse2)) return;
+    kernel_ = kernel;
+}
+
+void TickDecoder::index_delimiters(string_view buffer) {
+    delimiters_.clear();
+    if (delimiters_.capacity() < buffer.size() / 8) {
+        delimiters_.reserve(buffer.size() / 8); // ~9 delimiters per 90-byte record
+    }
+    switch (kernel_) {
+    #ifdef ENGINE_X86
+        case Kernel::AVX2: index_avx2(buffer.data(), buffer.size(), delimiters_); return;
+        case Kernel::SSE2: index_sse2(buffer.data(), buffer.size(), delimiters_); return;
+    #endif
+        default: index_scalar(buffer.data(), 0, buffer.size(), delimiters_); return;
+    }
+}
+
+bool TickDecoder::decode_line(const char* line, const uint32_t* commas, const char* line_end, TickerData& out) {
+    // Field i spans [start(i), end(i)); commas[] are offsets relative to `line`
+    auto start = [&](int i) { return i == 0 ? line : line + commas[i - 1] + 1; };
+    auto end = [&](int i) { return i == 7 ? line_end : line + commas[i]; };
+
+    if (!parse_uint(start(0), end(0), out.timestamp_ms)) return false;
+    if (end(1) == start(1)) return false;
+    if (!parse_uint(start(2), end(2), out.trade_id)) return false;
+    if (!parse_fixed8(start(3), end(3), out.open) ||
+        !parse_fixed8(start(4), end(4), out.high) ||
+        !parse_fixed8(start(5), end(5), out.low) ||
+        !parse_fixed8(start(6), end(6), out.close) ||
+        !parse_fixed8(start(7), end(7), out.volume)) return false;
+
+    string_view symbol(start(1), end(1) - start(1));
+    if (symbol != last_symbol_) {
+        last_symbol_.assign(symbol.data(), symbol.size());
+        last_symbol_id_ = intern_symbol(symbol);
+    }
+    if (last_symbol_id_ == INVALID_SYMBOL) return false; // Table full: the fallback reports it
+    out.symbol_id = last_symbol_id_;
+    out.flags = 0;
+    return true;
+}
+
+size_t TickDecoder::decode(string_view buffer, vector<TickerData>& out) {
+    index_delimiters(buffer);
+
+    const char* base = buffer.data();
+    size_t line_start = 0;
+    uint32_t commas[7];
+    size_t comma_count = 0;
+    size_t malformed = 0;
+
+    auto finish_line = [&](size_t line_end) {
+        size_t end = line_end;
+        if (end > line_start && base[end - 1] == '\r') --end;
+
+        if (end > line_start) {
+            const char* line = base + line_start;
+            out.emplace_back();
+            TickerData& tick = out.back();
+            if (comma_count != 7 || !decode_line(line, commas, base + end, tick)) {
+                // Not in the fixed layout (or malformed): let the general parser decide
+                ParseStatus status = parseTickerData(string_view(line, end - line_start), tick);
+                if (status != ParseStatus::Ok) {
+                    out.pop_back();
+                    ++malformed;
+                    if (on_error_) on_error_(string_view(line, end - line_start), status);
+                }
+            }
+        }
+        line_start = line_end + 1;
+        comma_count = 0;
+    };
+
+    for (uint32_t pos : delimiters_) {
+        if (base[pos] == ',') {
+            if (comma_count < 7) commas[comma_count] = static_cast<uint32_t>(pos - line_start);
+            ++comma_count;
+        } else {
+            finish_line(pos);
+        }
+    }
+    if (line_start < buffer.size()) {
+        finish_line(buffer.size());
+    }
+    return malformed;
+}
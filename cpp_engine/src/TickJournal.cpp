@@ -0,0 +1,357 @@
+#include "../include/TickJournal.h"
+#include "../include/Crc32c.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const uint32_t JOURNAL_VERSION = 1;
+static const size_t HEADER_SIZE = sizeof(JournalSegmentHeader);
+static const size_t RECORD_SIZE = sizeof(JournalRecord);
+
+namespace {
+
+struct SegmentFile {
+    uint64_t first_sequence;
+    string path;
+};
+
+string segment_path(const string& directory, uint64_t first_sequence) {
+    char name[64];
+    snprintf(name, sizeof(name), "ticks-%020llu.journal", static_cast<unsigned long long>(first_sequence));
+    return (fs::path(directory) / name).string();
+}
+
+// Segment files in sequence order
+vector<SegmentFile> list_segments(const string& directory) {
+    vector<SegmentFile> segments;
+    error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        string name = entry.path().filename().string();
+        unsigned long long first = 0;
+        char tail[16] = {};
+        if (sscanf(name.c_str(), "ticks-%20llu.%15s", &first, tail) == 2 && strcmp(tail, "journal") == 0) {
+            segments.push_back(SegmentFile{first, entry.path().string()});
+        }
+    }
+    sort(segments.begin(), segments.end(),
+         [](const SegmentFile& a, const SegmentFile& b) { return a.first_sequence < b.first_sequence; });
+    return segments;
+}
+
+// Covers the sequence number too, so a record copied to the wrong slot fails the check
+uint32_t record_crc(const JournalRecord& record, uint64_t sequence) {
+    uint32_t crc = crc32c(&sequence, sizeof(sequence));
+    return crc32c(reinterpret_cast<const char*>(&record) + sizeof(record.crc), RECORD_SIZE - sizeof(record.crc), crc);
+}
+
+bool valid_header(const MappedFile& file, JournalSegmentHeader& header) {
+    if (file.size() < HEADER_SIZE) return false;
+    memcpy(&header, file.data(), HEADER_SIZE);
+    return memcmp(header.magic, JOURNAL_MAGIC, sizeof(header.magic)) == 0 && header.version == JOURNAL_VERSION &&
+           header.record_size == RECORD_SIZE;
+}
+
+size_t slot_count(const MappedFile& file, const JournalSegmentHeader& header) {
+    size_t stored = (file.size() - HEADER_SIZE) / RECORD_SIZE;
+    return static_cast<size_t>(min<uint64_t>(header.capacity, stored));
+}
+
+bool read_record(const MappedFile& file, size_t slot, uint64_t sequence, JournalRecord& record) {
+    memcpy(&record, file.data() + HEADER_SIZE + slot * RECORD_SIZE, RECORD_SIZE);
+    return record.symbol_length > 0 && record.symbol_length <= JOURNAL_SYMBOL_BYTES &&
+           record.crc == record_crc(record, sequence);
+}
+
+// Number of leading valid records in a segment
+size_t count_valid(const MappedFile& file, const JournalSegmentHeader& header) {
+    size_t slots = slot_count(file, header);
+    JournalRecord record;
+    size_t valid = 0;
+    while (valid < slots && read_record(file, valid, header.first_sequence + valid, record)) ++valid;
+    return valid;
+}
+
+} // namespace
+
+// --- TickJournal ---
+
+TickJournal::TickJournal(const std::string& directory, size_t segment_records)
+    : directory_(directory), segment_records_(segment_records > 0 ? segment_records : 1) {}
+
+TickJournal::~TickJournal() {
+    close();
+}
+
+bool TickJournal::open() {
+    error_code ec;
+    fs::create_directories(directory_, ec);
+    if (ec) {
+        cerr << "FATAL: Could not create journal directory " << directory_ << ": " << ec.message() << endl;
+        return false;
+    }
+
+    // Earlier segments were trimmed when they were closed; only the newest can have a
+    // torn or unwritten tail (the engine stopped without close())
+    vector<SegmentFile> segments = list_segments(directory_);
+    uint64_t next = 1;
+    if (!segments.empty()) {
+        const SegmentFile& newest = segments.back();
+        MappedFile file;
+        JournalSegmentHeader header;
+        if (!file.open(newest.path, MappedFile::Mode::ReadOnly) || !valid_header(file, header)) {
+            file.close();
+            cerr << "[JOURNAL] Unreadable segment " << newest.path << " set aside as .bad." << endl;
+            fs::rename(newest.path, newest.path + ".bad", ec);
+            next = newest.first_sequence;
+        } else {
+            size_t valid = count_valid(file, header);
+            file.close();
+            next = header.first_sequence + valid;
+            if (valid == 0) {
+                fs::remove(newest.path, ec);
+            } else {
+                fs::resize_file(newest.path, HEADER_SIZE + valid * RECORD_SIZE, ec);
+            }
+        }
+    }
+
+    lock_guard<mutex> lock(mutex_);
+    next_sequence_ = next;
+    if (!start_segment(next)) return false;
+    stop_ = false;
+    sync_thread_ = std::thread(&TickJournal::sync_loop, this);
+    cout << "[JOURNAL] Writing to " << directory_ << " from sequence " << next << " (" << segments.size()
+         << " existing segments)." << endl;
+    return true;
+}
+
+void TickJournal::close() {
+    if (!sync_thread_.joinable()) return;
+    {
+        lock_guard<mutex> lock(mutex_);
+        stop_ = true;
+    }
+    sync_cv_.notify_all();
+    sync_thread_.join();
+    sync_now();
+
+    // Trim the unused tail so the next open() finds a clean end
+    lock_guard<mutex> lock(mutex_);
+    if (segment_) {
+        string path = segment_->path();
+        segment_.reset();
+        error_code ec;
+        if (segment_used_ == 0) {
+            fs::remove(path, ec);
+        } else {
+            fs::resize_file(path, HEADER_SIZE + segment_used_ * RECORD_SIZE, ec);
+        }
+    }
+    cout << "[JOURNAL] Closed at sequence " << next_sequence_ - 1 << "." << endl;
+}
+
+bool TickJournal::start_segment(uint64_t first_sequence) {
+    auto segment = make_shared<MappedFile>();
+    string path = segment_path(directory_, first_sequence);
+    if (!segment->open(path, MappedFile::Mode::ReadWrite, HEADER_SIZE + segment_records_ * RECORD_SIZE)) {
+        cerr << "ERROR: Could not create journal segment " << path << "." << endl;
+        return false;
+    }
+
+    JournalSegmentHeader header{};
+    memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+    header.version = JOURNAL_VERSION;
+    header.record_size = RECORD_SIZE;
+    header.first_sequence = first_sequence;
+    header.capacity = segment_records_;
+    memcpy(segment->data(), &header, HEADER_SIZE);
+
+    segment_ = std::move(segment);
+    segment_first_ = first_sequence;
+    segment_used_ = 0;
+    segment_synced_ = 0;
+    return true;
+}
+
+void TickJournal::append(const std::vector<TickerData>& ticks) {
+    lock_guard<mutex> lock(mutex_);
+    for (const TickerData& tick : ticks) {
+        string_view name = tick.symbol();
+        if (name.empty() || name.size() > JOURNAL_SYMBOL_BYTES) {
+            if (skipped_++ == 0) {
+                cerr << "[JOURNAL] Symbol \"" << name << "\" does not fit a journal record; its ticks are not journaled." << endl;
+            }
+            continue;
+        }
+
+        if (segment_ && segment_used_ == segment_records_) {
+            retired_.push_back(std::move(segment_)); // The sync thread flushes and releases it
+            start_segment(next_sequence_);
+        }
+        if (!segment_) {
+            ++skipped_; // Could not create a segment; ingest goes on without the journal
+            continue;
+        }
+
+        JournalRecord record{};
+        record.symbol_length = static_cast<uint32_t>(name.size());
+        record.timestamp_ms = tick.timestamp_ms;
+        record.trade_id = tick.trade_id;
+        memcpy(record.symbol, name.data(), name.size());
+        record.open = tick.open;
+        record.high = tick.high;
+        record.low = tick.low;
+        record.close = tick.close;
+        record.volume = tick.volume;
+        record.crc = record_crc(record, next_sequence_);
+
+        memcpy(segment_->data() + HEADER_SIZE + segment_used_ * RECORD_SIZE, &record, RECORD_SIZE);
+        ++segment_used_;
+        ++next_sequence_;
+    }
+}
+
+uint64_t TickJournal::last_sequence() {
+    lock_guard<mutex> lock(mutex_);
+    return next_sequence_ - 1;
+}
+
+size_t TickJournal::skipped_ticks() {
+    lock_guard<mutex> lock(mutex_);
+    return skipped_;
+}
+
+// --- Sync Thread ---
+
+void TickJournal::sync_loop() {
+    const auto interval = chrono::milliseconds(JOURNAL_SYNC_INTERVAL_MS);
+    unique_lock<mutex> lock(mutex_);
+    while (!stop_) {
+        sync_cv_.wait_for(lock, interval, [this] { return stop_; });
+        if (stop_) break;
+        lock.unlock();
+        sync_now();
+        lock.lock();
+    }
+}
+
+void TickJournal::sync_now() {
+    vector<shared_ptr<MappedFile>> retired;
+    shared_ptr<MappedFile> segment;
+    size_t from, to;
+    {
+        lock_guard<mutex> lock(mutex_);
+        retired.swap(retired_);
+        segment = segment_;
+        from = segment_synced_;
+        to = segment_used_;
+    }
+
+    // The msync/fdatasync happen outside the lock, so ingest keeps appending meanwhile
+    for (auto& full : retired) {
+        if (!full->sync(0, full->size())) cerr << "[JOURNAL] Sync failed for " << full->path() << "." << endl;
+    }
+    if (!segment || to == from) return;
+
+    size_t begin = from == 0 ? 0 : HEADER_SIZE + from * RECORD_SIZE; // First sync includes the header
+    if (!segment->sync(begin, HEADER_SIZE + to * RECORD_SIZE - begin)) {
+        cerr << "[JOURNAL] Sync failed for " << segment->path() << "." << endl;
+        return;
+    }
+    lock_guard<mutex> lock(mutex_);
+    if (segment_ == segment) segment_synced_ = max(segment_synced_, to);
+}
+
+// --- Retention ---
+
+void TickJournal::prune(uint64_t committed_through, size_t keep) {
+    uint64_t current_first;
+    {
+        lock_guard<mutex> lock(mutex_);
+        current_first = segment_ ? segment_first_ : next_sequence_;
+    }
+    vector<SegmentFile> segments = list_segments(directory_);
+    size_t closed = 0; // Segments before the one being written
+    while (closed < segments.size() && segments[closed].first_sequence < current_first) ++closed;
+
+    size_t removed = 0;
+    error_code ec;
+    // Segments are contiguous, so a segment ends right before the next one starts
+    for (size_t i = 0; i + keep < closed; ++i) {
+        uint64_t last = segments[i + 1].first_sequence - 1;
+        if (last > committed_through) break;
+        if (fs::remove(segments[i].path, ec)) ++removed;
+    }
+    if (removed > 0) {
+        cout << "[JOURNAL] Pruned " << removed << " committed segments." << endl;
+    }
+}
+
+// --- Reading ---
+
+bool scan_journal(const std::string& directory, uint64_t after, size_t batch_size,
+                  const std::function<bool(std::vector<TickerData>& batch)>& fn, JournalScanStats& stats) {
+    if (!fs::is_directory(directory)) {
+        cerr << "Error: journal directory " << directory << " not found." << endl;
+        return false;
+    }
+    vector<SegmentFile> segments = list_segments(directory);
+    vector<TickerData> batch;
+    batch.reserve(batch_size);
+    string last_symbol;
+    SymbolId last_id = INVALID_SYMBOL;
+
+    for (size_t i = 0; i < segments.size(); ++i) {
+        // Skip segments that end at or before `after` without mapping them
+        if (i + 1 < segments.size() && segments[i + 1].first_sequence <= after + 1) continue;
+
+        MappedFile file;
+        JournalSegmentHeader header;
+        if (!file.open(segments[i].path, MappedFile::Mode::ReadOnly) || !valid_header(file, header)) {
+            ++stats.bad_segments;
+            continue;
+        }
+        ++stats.segments;
+
+        size_t slots = slot_count(file, header);
+        JournalRecord record;
+        for (size_t slot = 0; slot < slots; ++slot) {
+            uint64_t sequence = header.first_sequence + slot;
+            if (!read_record(file, slot, sequence, record)) break; // End of the valid data
+            ++stats.records;
+            stats.bytes += RECORD_SIZE;
+            stats.last_sequence = max(stats.last_sequence, sequence);
+            if (sequence <= after) continue;
+
+            string_view name(record.symbol, record.symbol_length);
+            if (name != last_symbol) {
+                last_symbol.assign(name.data(), name.size());
+                last_id = intern_symbol(name);
+            }
+            if (last_id == INVALID_SYMBOL) continue;
+
+            TickerData tick{};
+            tick.timestamp_ms = record.timestamp_ms;
+            tick.symbol_id = last_id;
+            tick.trade_id = record.trade_id;
+            tick.open = record.open;
+            tick.high = record.high;
+            tick.low = record.low;
+            tick.close = record.close;
+            tick.volume = record.volume;
+            batch.push_back(tick);
+
+            if (batch.size() >= batch_size) {
+                if (!fn(batch)) return false;
+                batch.clear();
+            }
+        }
+    }
+    return batch.empty() || fn(batch);
+}
@@ -0,0 +1,48 @@
+#include "../include/TickProcessor.h"
+#include <cmath>
+
+using namespace std;
+
+TickProcessor::TickProcessor(const IndicatorRegistry& indicators)
+    : indicators_(indicators),
+      outputs_(indicators.output_names().size()),
+      vwap_output_(indicators.output_index("vwap")),
+      sma_output_(indicators.output_index("sma_20")),
+      ema_20_output_(indicators.output_index("ema_20")),
+      ema_50_output_(indicators.output_index("ema_50"))
+{
+    for (size_t i = 0; i < outputs_.size(); ++i) {
+        if (i != vwap_output_ && i != sma_output_ && i != ema_20_output_ && i != ema_50_output_) {
+            extra_outputs_.push_back(i);
+        }
+    }
+}
+
+void TickProcessor::update(const TickerData& tick, IndicatorSet& state) {
+    if (state.empty()) state = indicators_.create_set();
+    double* values = outputs_.data();
+    for (auto& indicator : state) {
+        indicator->update_outputs(tick, values);
+        values += indicator->output_count();
+    }
+}
+
+void TickProcessor::process(const TickerData& tick, IndicatorSet& state, WriteBatch& out) {
+    update(tick, state);
+    auto output = [this](size_t index) { return index != IndicatorRegistry::npos ? outputs_[index] : INDICATOR_WARMING_UP; };
+
+    out.metrics.push_back(MetricRow{
+        tick.timestamp_ms,
+        tick.trade_id,
+        tick.symbol_id,
+        output(vwap_output_),
+        output(sma_output_),
+        output(ema_20_output_),
+        output(ema_50_output_)
+    });
+    for (size_t index : extra_outputs_) {
+        if (std::isnan(outputs_[index])) continue; // Still warming up
+        out.indicators.push_back(IndicatorValue{
+            tick.timestamp_ms, tick.trade_id, tick.symbol_id, indicators_.output_names()[index], outputs_[index]});
+    }
+}
@@ -3,6 +3,8 @@
 #include <vector>
 #include <stdexcept> 
 #include <string> 
+#include <charconv>
+#include <system_error>
 
 TickerData parseTickerData(const std::string& csv_line) {
     TickerData data;
@@ -29,16 +31,93 @@ TickerData parseTickerData(const std::string& csv_line) {
 
     try {
         data.timestamp_ms = std::stoll(seglist[0]);
-        data.symbol = seglist[1];
         data.trade_id = std::stoll(seglist[2]); 
         data.open = std::stod(seglist[3]);
         data.high = std::stod(seglist[4]);
         data.low = std::stod(seglist[5]);
         data.close = std::stod(seglist[6]);
         data.volume = std::stod(seglist[7]); 
+        // Interned last: a malformed line must not take a slot in the symbol table
+        data.symbol_id = intern_symbol(seglist[1]);
+        data.flags = 0;
+        if (data.symbol_id == INVALID_SYMBOL) throw std::invalid_argument("symbol table full");
     } catch (const std::exception& e) {
         throw std::runtime_error("Data conversion error during parsing: " + std::string(e.what()));
     }
 
     return data;
-}
\ No newline at end of file
+}
+
+// --- Allocation-free parser ---
+
+namespace {
+
+// Pops the next ','-delimited field off `rest`; false once the line is exhausted
+inline bool next_field(std::string_view& rest, std::string_view& field) {
+    if (rest.data() == nullptr) return false;
+    size_t comma = rest.find(',');
+    if (comma == std::string_view::npos) {
+        field = rest;
+        rest = std::string_view();
+    } else {
+        field = rest.substr(0, comma);
+        rest.remove_prefix(comma + 1);
+    }
+    return true;
+}
+
+template <typename T>
+inline bool convert(std::string_view field, T& value) {
+    if (field.empty()) return false;
+    const char* end = field.data() + field.size();
+    auto result = std::from_chars(field.data(), end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+} // namespace
+
+const char* parse_status_message(ParseStatus status) {
+    switch (status) {
+        case ParseStatus::Ok:           return "OK";
+        case ParseStatus::FieldCount:   return "Invalid data format received. Expected 8 segments";
+        case ParseStatus::BadTimestamp: return "Invalid timestamp";
+        case ParseStatus::BadSymbol:    return "Empty symbol";
+        case ParseStatus::BadTradeId:   return "Invalid trade id";
+        case ParseStatus::BadPrice:     return "Invalid price";
+        case ParseStatus::BadVolume:    return "Invalid volume";
+    }
+    return "Unknown parse error";
+}
+
+ParseStatus parseTickerData(std::string_view csv_line, TickerData& out) {
+    if (!csv_line.empty() && csv_line.back() == '\r') {
+        csv_line.remove_suffix(1);
+    }
+
+    // Format: [0]timestamp_ms, [1]symbol, [2]trade_id, [3]open, [4]high, [5]low, [6]close, [7]volume
+    std::string_view fields[8];
+    std::string_view rest = csv_line;
+    size_t count = 0;
+    std::string_view field;
+    while (next_field(rest, field)) {
+        if (count == 8) return ParseStatus::FieldCount;
+        fields[count++] = field;
+    }
+    if (count != 8) return ParseStatus::FieldCount;
+
+    if (!convert(fields[0], out.timestamp_ms)) return ParseStatus::BadTimestamp;
+    if (fields[1].empty()) return ParseStatus::BadSymbol;
+    if (!convert(fields[2], out.trade_id)) return ParseStatus::BadTradeId;
+    if (!convert(fields[3], out.open) ||
+        !convert(fields[4], out.high) ||
+        !convert(fields[5], out.low) ||
+        !convert(fields[6], out.close)) return ParseStatus::BadPrice;
+    if (!convert(fields[7], out.volume)) return ParseStatus::BadVolume;
+
+    // Interned only once the whole line is valid: junk must not fill the symbol table
+    out.symbol_id = intern_symbol(fields[1]);
+    out.flags = 0;
+    if (out.symbol_id == INVALID_SYMBOL) return ParseStatus::BadSymbol;
+
+    return ParseStatus::Ok;
+}
@@ -0,0 +1,76 @@
+#include "../include/WireProtocol.h"
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+static const size_t MAX_SYMBOL_ID = 4096; // Bounds the per-connection symbol table
+
+bool BinaryFrameDecoder::decode(string_view bytes, vector<TickerData>& out, size_t& consumed) {
+    consumed = 0;
+
+    while (bytes.size() - consumed >= sizeof(WireFrameHeader)) {
+        WireFrameHeader header;
+        memcpy(&header, bytes.data() + consumed, sizeof(header));
+
+        if (header.version != WIRE_VERSION || header.payload_bytes > WIRE_MAX_PAYLOAD) {
+            cerr << "Protocol error: bad frame header (version " << (int)header.version
+                 << ", " << header.payload_bytes << " bytes)." << endl;
+            return false;
+        }
+        if (bytes.size() - consumed < sizeof(header) + header.payload_bytes) {
+            break; // Partial frame; wait for the rest
+        }
+
+        const char* payload = bytes.data() + consumed + sizeof(header);
+
+        if (header.type == FRAME_SYMBOL) {
+            uint32_t symbol_id;
+            uint8_t name_len;
+            if (header.payload_bytes < 5) return false;
+            memcpy(&symbol_id, payload, sizeof(symbol_id));
+            memcpy(&name_len, payload + 4, sizeof(name_len));
+            if (name_len == 0 || header.payload_bytes != 5u + name_len || symbol_id >= MAX_SYMBOL_ID) {
+                cerr << "Protocol error: malformed symbol frame." << endl;
+                return false;
+            }
+            if (symbols_.size() <= symbol_id) {
+                symbols_.resize(symbol_id + 1);
+                symbol_ids_.resize(symbol_id + 1, INVALID_SYMBOL);
+            }
+            symbols_[symbol_id].assign(payload + 5, name_len);
+            symbol_ids_[symbol_id] = intern_symbol(symbols_[symbol_id]);
+            if (symbol_ids_[symbol_id] == INVALID_SYMBOL) return false;
+
+        } else if (header.type == FRAME_TICKS) {
+            if (header.payload_bytes != header.count * sizeof(WireTick)) {
+                cerr << "Protocol error: tick frame length mismatch." << endl;
+                return false;
+            }
+            for (uint16_t i = 0; i < header.count; ++i) {
+                WireTick tick;
+                memcpy(&tick, payload + i * sizeof(WireTick), sizeof(tick));
+                if (tick.symbol_id >= symbols_.size() || symbols_[tick.symbol_id].empty()) {
+                    cerr << "Protocol error: tick references undeclared symbol id " << tick.symbol_id << endl;
+                    return false;
+                }
+
+                out.emplace_back();
+                TickerData& data = out.back();
+                data.timestamp_ms = tick.timestamp_ms;
+                data.symbol_id = symbol_ids_[tick.symbol_id];
+                data.flags = 0;
+                data.trade_id = tick.trade_id;
+                data.open = data.high = data.low = data.close = tick.price;
+                data.volume = tick.quantity;
+            }
+
+        } else {
+            cerr << "Protocol error: unknown frame type " << (int)header.type << endl;
+            return false;
+        }
+
+        consumed += sizeof(header) + header.payload_bytes;
+    }
+    return true;
+}
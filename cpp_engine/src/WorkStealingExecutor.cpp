@@ -0,0 +1,296 @@
+#include "../include/WorkStealingExecutor.h"
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+static uint64_t elapsed_ns(chrono::steady_clock::time_point since, chrono::steady_clock::time_point until) {
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(until - since).count());
+}
+
+// --- Constructor / Destructor ---
+
+WorkStealingExecutor::WorkStealingExecutor(PersistenceWriter& writer, const IndicatorRegistry& indicators, size_t workers)
+    : writer_(writer), actors_(new std::atomic<SymbolActor*>[MAX_SYMBOLS]) {
+    if (workers == 0) workers = 1;
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.push_back(make_unique<Worker>(indicators));
+    }
+    for (size_t i = 0; i < MAX_SYMBOLS; ++i) {
+        actors_[i].store(nullptr, memory_order_relaxed);
+    }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+    stop();
+}
+
+// --- Thread Control ---
+
+void WorkStealingExecutor::start() {
+    if (running_) return;
+    running_ = true;
+    last_stats_.assign(workers_.size(), WorkerStats{});
+    last_stats_time_ = chrono::steady_clock::now();
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        workers_[i]->thread = std::thread(&WorkStealingExecutor::worker_loop, this, i);
+    }
+    cout << "Work-stealing executor started with " << workers_.size() << " workers." << endl;
+}
+
+void WorkStealingExecutor::stop() {
+    if (!running_) return;
+    {
+        lock_guard<mutex> lock(park_mutex_);
+        running_ = false;
+    }
+    work_available_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+
+    // Bars still open have no closing trade yet; persist them as partial bars
+    WriteBatch open_bars;
+    size_t late_trades = 0;
+    for (auto& actor : owned_actors_) {
+        actor->bars.flush(open_bars.bars);
+        late_trades += actor->late_trades;
+    }
+    if (!open_bars.bars.empty()) {
+        cout << "[SHUTDOWN FLUSH] Writing " << open_bars.bars.size() << " open bars ("
+             << late_trades << " late trades skipped)." << endl;
+        writer_.submit(std::move(open_bars));
+    }
+
+    log_stats();
+    cout << "Work-stealing executor stopped." << endl;
+}
+
+// --- Producer Side (ingest threads) ---
+
+WorkStealingExecutor::SymbolActor& WorkStealingExecutor::actor_for(SymbolId id) {
+    SymbolActor* actor = actors_[id].load(memory_order_acquire);
+    if (actor) return *actor;
+
+    lock_guard<mutex> lock(create_mutex_);
+    actor = actors_[id].load(memory_order_relaxed);
+    if (!actor) {
+        owned_actors_.push_back(make_unique<SymbolActor>());
+        actor = owned_actors_.back().get();
+        actor->home.store(id % workers_.size(), memory_order_relaxed); // Spread new symbols out
+        actors_[id].store(actor, memory_order_release);
+    }
+    return *actor;
+}
+
+void WorkStealingExecutor::push_bulk(std::vector<TickerData>& batch) {
+    if (batch.empty()) return;
+
+    // Backpressure: like a full SafeQueue, wait for the workers instead of growing mailboxes
+    while (pending_ticks_.load(memory_order_relaxed) >= QUEUE_CAPACITY && running_) {
+        this_thread::yield();
+    }
+
+    // Group the batch by symbol (order kept within each) so each mailbox is locked once
+    thread_local vector<SymbolId> symbols;
+    thread_local vector<vector<TickerData>> groups;
+    size_t used = 0;
+    size_t last = 0;
+    for (const TickerData& tick : batch) {
+        if (used == 0 || symbols[last] != tick.symbol_id) {
+            last = 0;
+            while (last < used && symbols[last] != tick.symbol_id) ++last;
+            if (last == used) {
+                if (used == symbols.size()) {
+                    symbols.emplace_back();
+                    groups.emplace_back();
+                }
+                symbols[used++] = tick.symbol_id;
+            }
+        }
+        groups[last].push_back(tick);
+    }
+    batch.clear();
+
+    for (size_t i = 0; i < used; ++i) {
+        SymbolActor& actor = actor_for(symbols[i]);
+        vector<TickerData>& ticks = groups[i];
+        bool wake;
+        {
+            lock_guard<mutex> lock(actor.mutex);
+            actor.inbox.insert(actor.inbox.end(), ticks.begin(), ticks.end());
+            wake = !actor.scheduled;
+            actor.scheduled = true;
+        }
+        pending_ticks_.fetch_add(ticks.size(), memory_order_relaxed);
+        ticks.clear();
+        if (wake) schedule(actor, actor.home.load(memory_order_relaxed));
+    }
+}
+
+void WorkStealingExecutor::schedule(SymbolActor& actor, size_t worker) {
+    {
+        lock_guard<mutex> lock(workers_[worker]->mutex);
+        workers_[worker]->queue.push_back(&actor);
+    }
+    queued_.fetch_add(1);
+    // Pairs with the idle_workers_ increment in worker_loop: either the parked worker
+    // sees queued_ > 0 before sleeping, or this sees it idle and wakes it
+    if (idle_workers_.load() > 0) {
+        lock_guard<mutex> lock(park_mutex_);
+        work_available_.notify_one();
+    }
+}
+
+// --- Worker Side ---
+
+WorkStealingExecutor::SymbolActor* WorkStealingExecutor::take_local(Worker& worker) {
+    lock_guard<mutex> lock(worker.mutex);
+    if (worker.queue.empty()) return nullptr;
+    SymbolActor* actor = worker.queue.front();
+    worker.queue.pop_front();
+    queued_.fetch_sub(1);
+    return actor;
+}
+
+WorkStealingExecutor::SymbolActor* WorkStealingExecutor::steal(size_t thief) {
+    for (size_t offset = 1; offset < workers_.size(); ++offset) {
+        Worker& victim = *workers_[(thief + offset) % workers_.size()];
+        lock_guard<mutex> lock(victim.mutex);
+        if (victim.queue.empty()) continue;
+        SymbolActor* actor = victim.queue.back(); // Queued last, so it would wait longest there
+        victim.queue.pop_back();
+        queued_.fetch_sub(1);
+        return actor;
+    }
+    return nullptr;
+}
+
+void WorkStealingExecutor::run_actor(size_t index, SymbolActor& actor) {
+    Worker& worker = *workers_[index];
+    auto started = chrono::steady_clock::now();
+    actor.home.store(index, memory_order_relaxed);
+
+    {
+        lock_guard<mutex> lock(actor.mutex);
+        actor.work.swap(actor.inbox);
+    }
+    pending_ticks_.fetch_sub(actor.work.size(), memory_order_relaxed);
+
+    if (worker.pending.raw.empty()) worker.pending_since = started;
+    for (const TickerData& tick : actor.work) {
+        if (tick.flags & TICK_ALREADY_STORED) {
+            // The bars this closes were written along with the trade that closed them
+            if (!actor.bars.add(tick, worker.stored_bars)) ++actor.late_trades;
+            worker.stored_bars.clear();
+            worker.processor.warm_up(tick, actor.indicators);
+            continue;
+        }
+        worker.pending.raw.push_back(tick);
+        if (!actor.bars.add(tick, worker.pending.bars)) ++actor.late_trades;
+        worker.processor.process(tick, actor.indicators, worker.pending);
+    }
+    worker.ticks.fetch_add(actor.work.size(), memory_order_relaxed);
+    worker.runs.fetch_add(1, memory_order_relaxed);
+    actor.work.clear();
+
+    // Ticks that arrived meanwhile go to the back of this worker's deque, so other
+    // actors get a turn and the symbol stays with the worker whose cache holds it
+    bool more;
+    {
+        lock_guard<mutex> lock(actor.mutex);
+        more = !actor.inbox.empty();
+        if (!more) actor.scheduled = false;
+    }
+    if (more) schedule(actor, index);
+
+    if (worker.pending.raw.size() >= static_cast<size_t>(BATCH_SIZE)) flush_pending(worker);
+    worker.busy_ns.fetch_add(elapsed_ns(started, chrono::steady_clock::now()), memory_order_relaxed);
+}
+
+void WorkStealingExecutor::flush_pending(Worker& worker) {
+    if (worker.pending.raw.empty()) return;
+    // The writer thread owns the transaction; this only blocks under backpressure
+    writer_.submit(std::move(worker.pending));
+    worker.pending = WriteBatch();
+}
+
+void WorkStealingExecutor::worker_loop(size_t index) {
+    Worker& worker = *workers_[index];
+    const auto flush_timeout = chrono::milliseconds(FLUSH_TIMEOUT_MS);
+
+    while (true) {
+        SymbolActor* actor = take_local(worker);
+        if (!actor) {
+            actor = steal(index);
+            if (actor) worker.steals.fetch_add(1, memory_order_relaxed);
+        }
+        if (actor) {
+            run_actor(index, *actor);
+            continue;
+        }
+
+        auto now = chrono::steady_clock::now();
+        if (!worker.pending.raw.empty() && now - worker.pending_since >= flush_timeout) {
+            cout << "[TIMEOUT FLUSH] Worker " << index << ": processing final batch of " << worker.pending.raw.size()
+                 << " items due to timeout." << endl;
+            flush_pending(worker);
+        }
+        // Ingest has stopped by now; an actor still running elsewhere requeues on its own worker
+        if (!running_ && queued_.load() == 0) break;
+
+        unique_lock<mutex> lock(park_mutex_);
+        idle_workers_.fetch_add(1);
+        auto deadline = worker.pending.raw.empty() ? now + flush_timeout : worker.pending_since + flush_timeout;
+        work_available_.wait_until(lock, deadline, [this] { return queued_.load() > 0 || !running_; });
+        idle_workers_.fetch_sub(1);
+    }
+
+    if (!worker.pending.raw.empty()) {
+        cout << "[SHUTDOWN FLUSH] Worker " << index << ": processing final batch of " << worker.pending.raw.size()
+             << " items." << endl;
+        flush_pending(worker);
+    }
+}
+
+// --- Stats ---
+
+std::vector<WorkStealingExecutor::WorkerStats> WorkStealingExecutor::stats() const {
+    vector<WorkerStats> out;
+    out.reserve(workers_.size());
+    for (const auto& worker : workers_) {
+        WorkerStats s;
+        s.ticks = worker->ticks.load(memory_order_relaxed);
+        s.runs = worker->runs.load(memory_order_relaxed);
+        s.steals = worker->steals.load(memory_order_relaxed);
+        s.busy_ns = worker->busy_ns.load(memory_order_relaxed);
+        out.push_back(s);
+    }
+    return out;
+}
+
+void WorkStealingExecutor::log_stats() {
+    vector<WorkerStats> current = stats();
+    auto now = chrono::steady_clock::now();
+    double window_ns = static_cast<double>(elapsed_ns(last_stats_time_, now));
+    if (window_ns <= 0.0) return;
+
+    size_t symbols;
+    {
+        lock_guard<mutex> lock(create_mutex_);
+        symbols = owned_actors_.size();
+    }
+    cout << "[EXECUTOR] " << symbols << " symbols, " << pending_ticks_.load(memory_order_relaxed)
+         << " ticks pending |";
+    for (size_t i = 0; i < current.size(); ++i) {
+        const WorkerStats& before = last_stats_[i];
+        double utilization = 100.0 * static_cast<double>(current[i].busy_ns - before.busy_ns) / window_ns;
+        cout << " w" << i << " " << fixed << setprecision(1) << utilization << "% busy, "
+             << (current[i].ticks - before.ticks) << " ticks, " << (current[i].steals - before.steals) << " steals"
+             << (i + 1 < current.size() ? " |" : "");
+    }
+    cout << defaultfloat << endl;
+
+    last_stats_ = std::move(current);
+    last_stats_time_ = now;
+}
@@ -3,20 +3,37 @@
 #include <thread>
 #include <chrono>
 #include <csignal>
+#include <cstdlib>
+#include <climits>
 #include <atomic>
+#include <memory>
+#include <vector>
+#include <iomanip>
 #include "../include/Persistence.h" 
-#include "../include/SafeQueue.h"
+#include "../include/PersistenceWriter.h"
+#include "../include/ShardRouter.h"
 #include "../include/DataIngestor.h"
 #include "../include/ProcessingThread.h"
+#include "../include/WorkStealingExecutor.h"
+#include "../include/Indicators.h"
+#include "../include/Backfill.h"
+#include "../include/TickJournal.h"
+#include "../include/ColumnarTickStore.h"
+#include "../include/PartitionedDatabase.h"
+#include "../include/RetentionCompactor.h"
+#include "../include/UtcTime.h"
+#include "../include/Constants.h"
 
 using namespace std;
 
 std::atomic<bool> g_running{true};
 
-SafeQueue<TickerData>* g_queue = nullptr;
+ShardRouter* g_router = nullptr;
 DataIngestor* g_ingestor = nullptr;
-ProcessingThread* g_processor = nullptr;
+std::vector<std::unique_ptr<ProcessingThread>>* g_processors = nullptr;
+WorkStealingExecutor* g_executor = nullptr;
 PersistenceManager* g_dbManager = nullptr;
+PersistenceWriter* g_writer = nullptr;
 
 void signal_handler(int signum) {
     if (signum == SIGINT || signum == SIGTERM) {
@@ -31,10 +48,176 @@ void signal_handler(int signum) {
     }
 }
 
-int main() {
+int main(int argc, char** argv) {
     cout << "--- Crypto Data Engine Started ---" << endl;
     
     signal(SIGINT, signal_handler);
+
+    string indicator_spec = DEFAULT_INDICATORS;
+    string recompute_symbol;
+    int shards = PROCESSING_SHARDS;
+    int workers = PROCESSING_WORKERS;
+    bool work_stealing = true;
+    bool journal_enabled = true;
+    bool columnar = false;
+    int partition_hours = 0;
+    bool compress_ticks = false;
+    bool fixed_point = true;
+    RetentionPolicy retention;
+    bool compact_once = false;
+    bool vacuum = false;
+    string replay_dir;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--indicators" && i + 1 < argc) {
+            indicator_spec = argv[++i];
+        } else if (arg == "--recompute" && i + 1 < argc) {
+            recompute_symbol = argv[++i];
+        } else if (arg == "--shards" && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            shards = atoi(argv[++i]);
+        } else if (arg == "--workers" && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            workers = atoi(argv[++i]);
+        } else if (arg == "--scheduler" && i + 1 < argc && (string(argv[i + 1]) == "stealing" || string(argv[i + 1]) == "sharded")) {
+            work_stealing = string(argv[++i]) == "stealing";
+        } else if (arg == "--tick-store" && i + 1 < argc && (string(argv[i + 1]) == "sqlite" || string(argv[i + 1]) == "columnar")) {
+            columnar = string(argv[++i]) == "columnar";
+        } else if (arg == "--partition-hours" && i + 1 < argc && atoi(argv[i + 1]) > 0 &&
+                   (24 % atoi(argv[i + 1]) == 0 || atoi(argv[i + 1]) % 24 == 0)) {
+            partition_hours = atoi(argv[++i]);
+        } else if (arg == "--compress-ticks") {
+            compress_ticks = true;
+        } else if (arg == "--float-codec" && i + 1 < argc && (string(argv[i + 1]) == "fixed" || string(argv[i + 1]) == "xor")) {
+            fixed_point = string(argv[++i]) == "fixed";
+        } else if (arg == "--keep-ticks-days" && i + 1 < argc && atof(argv[i + 1]) > 0) {
+            retention.tick_retention_ms = static_cast<long long>(atof(argv[++i]) * DAY_MS);
+        } else if (arg == "--keep-metrics-days" && i + 1 < argc && atof(argv[i + 1]) > 0) {
+            retention.metric_retention_ms = static_cast<long long>(atof(argv[++i]) * DAY_MS);
+        } else if (arg == "--metrics-resolution" && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            retention.metric_resolution_ms = atoi(argv[++i]) * 1000LL;
+        } else if (arg == "--compact") {
+            compact_once = true;
+        } else if (arg == "--vacuum") {
+            vacuum = true;
+        } else if (arg == "--no-journal") {
+            journal_enabled = false;
+        } else if (arg == "--replay-journal" && i + 1 < argc) {
+            replay_dir = argv[++i];
+        } else {
+            cerr << "Usage: " << argv[0] << " [--indicators SPEC] [--scheduler stealing|sharded] [--workers N] [--shards N] [--tick-store sqlite|columnar] [--partition-hours N] [--keep-ticks-days D] [--keep-metrics-days D [--metrics-resolution S]] [--compact] [--vacuum] [--no-journal] [--replay-journal DIR] [--recompute SYMBOL] [--compress-ticks [--float-codec fixed|xor]]" << endl
+                 << "  --indicators SPEC   streaming indicator set (default: " << DEFAULT_INDICATORS << ")" << endl
+                 << "  --scheduler MODE    stealing: workers share per-symbol work (default); sharded: one thread per fixed symbol shard" << endl
+                 << "  --workers N         work-stealing worker threads (default: " << PROCESSING_WORKERS << ")" << endl
+                 << "  --shards N          sharded processing threads, symbols split between them by hash (default: " << PROCESSING_SHARDS << ")" << endl
+                 << "  --tick-store MODE   sqlite: raw trades in raw_ohlcv_data (default); columnar: per-symbol/day segment files in " << TICK_STORE_DIR << endl
+                 << "  --partition-hours N one SQLite file per N hours (N divides 24 or is a multiple of it) in " << DB_PARTITION_DIR << " instead of a single DB" << endl
+                 << "  --keep-ticks-days D   roll raw trades older than D days into 1m bars and delete them (background, in small chunks)" << endl
+                 << "  --keep-metrics-days D thin metrics and indicator values older than D days to one row per symbol and resolution bucket" << endl
+                 << "  --metrics-resolution S  bucket width in seconds for thinned metrics (default: " << RETENTION_METRIC_RESOLUTION_MS / 1000 << ")" << endl
+                 << "  --compact           run one retention pass with the --keep-* policy and exit" << endl
+                 << "  --vacuum            rewrite the DB (and partition) files to return their free space to the OS and exit; may follow --compact" << endl
+                 << "  --no-journal        do not write ingested ticks to the crash-recovery journal in " << JOURNAL_DIR << endl
+                 << "  --replay-journal DIR  feed the ticks journaled in DIR that are missing from the DB through the pipeline and exit" << endl
+                 << "  --recompute SYMBOL  rebuild SYMBOL's aggregated_metrics from stored trades and exit" << endl
+                 << "  --compress-ticks    compress the sealed columnar segments of days before today (UTC) and exit" << endl
+                 << "  --float-codec MODE  fixed: prices/quantities as fixed-point decimals where exact, else XOR (default); xor: always XOR" << endl;
+            return 1;
+        }
+    }
+
+    if (compress_ticks) {
+        long long now_ms = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+        long long today_ms = floor_to_interval(now_ms, DAY_MS);
+        TickCompressionStats stats;
+        auto started = chrono::steady_clock::now();
+        bool ok = compress_tick_segments(TICK_STORE_DIR, today_ms, fixed_point, stats);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+
+        uint64_t packed = 0;
+        for (uint64_t bytes : stats.column_bytes) packed += bytes;
+        cout << "[COMPRESS] " << stats.segments << " segments, " << stats.rows << " trades in " << stats.blocks
+             << " blocks, " << stats.raw_bytes << " -> " << packed << " bytes";
+        if (packed > 0) cout << " (" << fixed << setprecision(1) << double(stats.raw_bytes) / packed << "x)";
+        cout << " in " << fixed << setprecision(2) << seconds << " s" << endl;
+        if (stats.rows > 0) {
+            const char* names[4] = {"timestamp", "trade_id", "price", "qty"};
+            cout << "[COMPRESS] Bits per value:";
+            for (size_t c = 0; c < 4; ++c) {
+                cout << " " << names[c] << " " << setprecision(2) << 8.0 * stats.column_bytes[c] / stats.rows;
+            }
+            cout << " (fixed-point price/qty blocks: " << stats.fixed_point_blocks << "/" << 2 * stats.blocks << ")" << endl;
+        }
+        return ok ? 0 : 1;
+    }
+
+    if (compact_once || vacuum) {
+        if (compact_once && !retention.enabled()) {
+            cerr << "--compact needs --keep-ticks-days and/or --keep-metrics-days." << endl;
+            return 1;
+        }
+        PersistenceManager dbManager;
+        if (!dbManager.open_db()) {
+            cerr << "FATAL: Could not connect to database. Exiting." << endl;
+            return 1;
+        }
+        unique_ptr<PartitionedDatabase> partitioned;
+        if (partition_hours > 0) {
+            partitioned = make_unique<PartitionedDatabase>(dbManager, partition_hours * HOUR_MS);
+            if (!partitioned->migrate_partitions()) return 1;
+        }
+        bool ok = true;
+        if (compact_once) {
+            RetentionCompactor compactor(retention, DB_FILE, partitioned.get());
+            RetentionStats stats;
+            ok = compactor.run_once(stats);
+            if (stats.chunks == 0) cout << "[RETENTION] Nothing to compact." << endl;
+        }
+        if (vacuum) {
+            ok = dbManager.vacuum() && ok;
+            if (partitioned) {
+                for (const DbPartition& partition : partitioned->partitions(LLONG_MIN, LLONG_MAX)) {
+                    PersistenceManager db;
+                    db.set_symbol_catalog(dbManager);
+                    ok = db.open_db(partition.path) && db.vacuum() && ok;
+                    db.close_db();
+                }
+            }
+        }
+        dbManager.close_db();
+        return ok ? 0 : 1;
+    }
+
+    if (!recompute_symbol.empty()) {
+        PersistenceManager dbManager;
+        if (!dbManager.open_db()) {
+            cerr << "FATAL: Could not connect to database. Exiting." << endl;
+            return 1;
+        }
+        unique_ptr<PartitionedDatabase> partitioned;
+        PersistenceBackend* sql_backend = &dbManager;
+        if (partition_hours > 0) {
+            partitioned = make_unique<PartitionedDatabase>(dbManager, partition_hours * HOUR_MS);
+            if (!partitioned->open()) return 1;
+            sql_backend = partitioned.get();
+        }
+        bool ok;
+        if (columnar) {
+            ColumnarTickStore tick_store(*sql_backend);
+            ok = recompute_metrics(tick_store, recompute_symbol);
+        } else {
+            ok = recompute_metrics(*sql_backend, recompute_symbol);
+        }
+        if (partitioned) partitioned->close();
+        dbManager.close_db();
+        return ok ? 0 : 1;
+    }
+
+    IndicatorRegistry indicators;
+    string spec_error;
+    if (!indicators.configure(indicator_spec, spec_error)) {
+        cerr << "FATAL: Invalid indicator spec \"" << indicator_spec << "\": " << spec_error << endl;
+        return 1;
+    }
+    cout << "Indicators: " << indicator_spec << endl;
     
     PersistenceManager dbManager;
     g_dbManager = &dbManager;
@@ -44,17 +227,122 @@ int main() {
         return 1;
     }
     
-    SafeQueue<TickerData> dataQueue;
-    g_queue = &dataQueue; 
+    // Ticks journaled after the last clean shutdown may never have reached the DB; they are
+    // replayed below, before new ticks arrive. Replayed ticks are not journaled again.
+    unique_ptr<TickJournal> journal;
+    uint64_t watermark = 0;
+    if (replay_dir.empty() && journal_enabled) {
+        journal = make_unique<TickJournal>();
+        if (!journal->open()) {
+            cerr << "FATAL: Could not open the tick journal. Exiting (--no-journal runs without it)." << endl;
+            return 1;
+        }
+        if (!dbManager.load_journal_watermark(watermark)) {
+            cerr << "FATAL: Could not read the journal watermark. Exiting." << endl;
+            return 1;
+        }
+        journal->prune(watermark);
+    }
+
+    size_t processing_threads = static_cast<size_t>(work_stealing ? workers : shards);
     
-    ProcessingThread dataProcessor(dataQueue, dbManager);
-    g_processor = &dataProcessor;
-    dataProcessor.start_thread();
+    // SQLite rows go to the single DB or to per-interval partitions (dbManager then only
+    // keeps the schema and journal_state); raw trades may go to columnar segments instead
+    unique_ptr<PartitionedDatabase> partitioned;
+    PersistenceBackend* sql_backend = &dbManager;
+    if (partition_hours > 0) {
+        partitioned = make_unique<PartitionedDatabase>(dbManager, partition_hours * HOUR_MS);
+        if (!partitioned->open()) return 1;
+        sql_backend = partitioned.get();
+    }
+    unique_ptr<ColumnarTickStore> tick_store;
+    PersistenceBackend* backend = sql_backend;
+    if (columnar) {
+        tick_store = make_unique<ColumnarTickStore>(*sql_backend);
+        if (!tick_store->open()) return 1;
+        backend = tick_store.get();
+    }
     
-    DataIngestor dataIngestor(dataQueue);
+    // All processing threads share one writer, so their batches land in the same group commits
+    PersistenceWriter dbWriter(*backend, MAX_IN_FLIGHT_BATCHES * processing_threads);
+    g_writer = &dbWriter;
+    dbWriter.start_thread();
+    
+    unique_ptr<WorkStealingExecutor> executor;
+    unique_ptr<ShardRouter> router;
+    vector<unique_ptr<ProcessingThread>> processors;
+    TickSink* sink;
+    if (work_stealing) {
+        executor = make_unique<WorkStealingExecutor>(dbWriter, indicators, processing_threads);
+        executor->start();
+        g_executor = executor.get();
+        sink = executor.get();
+    } else {
+        router = make_unique<ShardRouter>(processing_threads);
+        for (size_t shard = 0; shard < router->shard_count(); ++shard) {
+            processors.push_back(make_unique<ProcessingThread>(router->queue(shard), dbWriter, indicators, shard));
+            processors.back()->start_thread();
+        }
+        g_router = router.get();
+        g_processors = &processors;
+        sink = router.get();
+        cout << "Processing split across " << router->shard_count() << " shards." << endl;
+    }
+    
+    bool replay_ok = true;
+    if (!replay_dir.empty() || (journal && journal->last_sequence() > watermark)) {
+        // Separate connection, so lookups see exactly what the writer has committed
+        string directory = replay_dir.empty() ? journal->directory() : replay_dir;
+        uint64_t after = replay_dir.empty() ? watermark : 0;
+        if (partitioned) {
+            PartitionedDatabase lookup(dbManager, partitioned->interval_ms()); // Reads only
+            replay_ok = replay_journal(directory, after, lookup, *sink);
+        } else {
+            DbConfig lookup_config;
+            lookup_config.checkpoint_interval_ms = 0;
+            PersistenceManager lookup;
+            replay_ok = lookup.open_db(DB_FILE, lookup_config) && replay_journal(directory, after, lookup, *sink);
+            lookup.close_db();
+        }
+    }
+    if (!replay_dir.empty() || !replay_ok) {
+        g_running = false; // Offline replay (or a failed startup replay): skip ingestion
+    }
+
+    // start_server() blocks the main thread, so utilization is reported from a side thread
+    thread stats_reporter;
+    if (g_executor) {
+        stats_reporter = thread([] {
+            auto last_stats = chrono::steady_clock::now();
+            while (g_running) {
+                this_thread::sleep_for(chrono::milliseconds(500));
+                if (g_running && chrono::steady_clock::now() - last_stats >= chrono::milliseconds(EXECUTOR_STATS_INTERVAL_MS)) {
+                    g_executor->log_stats();
+                    last_stats = chrono::steady_clock::now();
+                }
+            }
+        });
+    }
+    
+    unique_ptr<JournalingSink> journaling_sink;
+    if (journal) {
+        journaling_sink = make_unique<JournalingSink>(*journal, *sink);
+        sink = journaling_sink.get();
+    }
+    
+    // Retention runs on its own connection and only ever holds the write lock for one chunk
+    unique_ptr<RetentionCompactor> compactor;
+    if (retention.enabled() && g_running) {
+        compactor = make_unique<RetentionCompactor>(retention, DB_FILE, partitioned.get());
+        compactor->start();
+    }
+    
+    DataIngestor dataIngestor(*sink);
     g_ingestor = &dataIngestor;
 
-    dataIngestor.start_server(); 
+    if (g_running) {
+        dataIngestor.start_server(); 
+    }
 
     cout << "Main thread entering monitoring loop. Press CTRL+C to stop." << endl;
     
@@ -64,8 +352,43 @@ int main() {
     
     cout << "Starting shutdown..." << endl;
     
-    if (g_processor) {
-        g_processor->stop_thread(); 
+    if (compactor) {
+        compactor->stop(); // Finishes the chunk in progress
+    }
+    if (stats_reporter.joinable()) {
+        stats_reporter.join();
+    }
+    if (g_executor) {
+        g_executor->stop(); // Runs every mailbox dry first
+    }
+    if (g_processors) {
+        for (auto& processor : *g_processors) {
+            processor->stop_thread(); // Each shard drains its own queue first
+        }
+    }
+    
+    if (g_writer) {
+        g_writer->stop_thread(); // Commits everything the processor flushed
+    }
+    if (tick_store) {
+        tick_store->close(); // Seals the open segments
+    }
+    if (partitioned) {
+        partitioned->close();
+    }
+    
+    // Everything journaled so far is committed unless a group commit was rolled back;
+    // otherwise the next start replays from the old watermark
+    if (journal) {
+        if (replay_ok && dbWriter.failed_groups() == 0) {
+            dbManager.save_journal_watermark(journal->last_sequence());
+        } else {
+            cerr << "[JOURNAL] Not all journaled ticks were committed; they are replayed on the next start." << endl;
+        }
+        if (journal->skipped_ticks() > 0) {
+            cerr << "[JOURNAL] " << journal->skipped_ticks() << " ticks could not be journaled." << endl;
+        }
+        journal->close();
     }
     
     if (g_dbManager) {
@@ -73,5 +396,5 @@ int main() {
     }
     
     cout << "--- Engine Shutdown Complete ---" << endl;
-    return 0;
+    return replay_ok ? 0 : 1;
 }
\ No newline at end of file
@@ -1,38 +1,89 @@
--- 1. Table for Raw (OHLCV) Candlestick Data
+-- Schema version 1 (PRAGMA user_version, last line). Databases created from an older
+-- schema.sql are migrated by the engine when it opens them (see Persistence.cpp).
+
+-- 0. Symbol Dimension: the hot tables below store symbol_id instead of the name
+CREATE TABLE IF NOT EXISTS symbols (
+    symbol_id INTEGER PRIMARY KEY,
+    symbol TEXT NOT NULL UNIQUE
+);
+
+
+-- 1. Table for Raw (OHLCV) Candlestick Data, clustered by symbol and time
 CREATE TABLE IF NOT EXISTS raw_ohlcv_data (
-    trade_id INTEGER NOT NULL,  
-    symbol TEXT NOT NULL,
+    symbol_id INTEGER NOT NULL,
     open_time_ms INTEGER NOT NULL,
-    
+    trade_id INTEGER NOT NULL,
+
     open_price REAL NOT NULL,
     high_price REAL NOT NULL,
     low_price REAL NOT NULL,
     close_price REAL NOT NULL,
     volume REAL NOT NULL,
-    
-    ingestion_timestamp TEXT DEFAULT (strftime('%Y-%m-%d %H:%M:%S', 'now', 'localtime')),
-    
-    PRIMARY KEY (trade_id, symbol) 
-);
 
-CREATE INDEX IF NOT EXISTS idx_raw_symbol ON raw_ohlcv_data (symbol);
-CREATE INDEX IF NOT EXISTS idx_raw_time ON raw_ohlcv_data (open_time_ms);
+    ingested_ms INTEGER NOT NULL,  -- Unix ms (UTC) at which the engine wrote the row
+
+    PRIMARY KEY (symbol_id, open_time_ms, trade_id)
+) WITHOUT ROWID;
 
 
 -- 2. Table for Aggregated/Processed Metrics
 CREATE TABLE IF NOT EXISTS aggregated_metrics (
-    trade_id INTEGER NOT NULL,
-    symbol TEXT NOT NULL,
+    symbol_id INTEGER NOT NULL,
     open_time_ms INTEGER NOT NULL,
-    
+    trade_id INTEGER NOT NULL,
+
     -- Metrike
-    vwap REAL, 
+    vwap REAL,
     simple_average REAL,
     ema_20 REAL,
     ema_50 REAL,
-    
-    PRIMARY KEY (trade_id, symbol) 
+
+    PRIMARY KEY (symbol_id, open_time_ms, trade_id)
+) WITHOUT ROWID;
+
+
+-- 3. Table for OHLCV Bars rolled up from the trade stream by the engine (1s, 1m, 5m, 1h)
+CREATE TABLE IF NOT EXISTS ohlcv_bars (
+    symbol_id INTEGER NOT NULL,
+    interval_ms INTEGER NOT NULL,
+    open_time_ms INTEGER NOT NULL,
+
+    open_price REAL NOT NULL,
+    high_price REAL NOT NULL,
+    low_price REAL NOT NULL,
+    close_price REAL NOT NULL,
+    volume REAL NOT NULL,
+    quote_volume REAL NOT NULL,  -- Sum of price * quantity; vwap = quote_volume / volume
+    trade_count INTEGER NOT NULL,
+
+    PRIMARY KEY (symbol_id, interval_ms, open_time_ms)
+) WITHOUT ROWID;
+
+
+-- 4. Table for Indicator Outputs beyond the aggregated_metrics columns (engine --indicators spec)
+CREATE TABLE IF NOT EXISTS indicator_values (
+    symbol_id INTEGER NOT NULL,
+    open_time_ms INTEGER NOT NULL,
+    trade_id INTEGER NOT NULL,
+
+    name TEXT NOT NULL,          -- e.g. rsi_14, macd_hist_12_26_9, bb_upper_20_2
+    value REAL,
+
+    PRIMARY KEY (symbol_id, open_time_ms, trade_id, name)
+) WITHOUT ROWID;
+
+
+-- 5. Journal Watermark: highest tick-journal sequence known to be committed above (single row)
+CREATE TABLE IF NOT EXISTS journal_state (
+    id INTEGER PRIMARY KEY CHECK (id = 0),
+    committed_sequence INTEGER NOT NULL
+);
+
+
+-- 6. Retention Watermarks: engine --keep-metrics-days has thinned metrics before done_before_ms
+CREATE TABLE IF NOT EXISTS retention_state (
+    name TEXT PRIMARY KEY,       -- aggregated_metrics
+    done_before_ms INTEGER NOT NULL
 );
 
-CREATE INDEX IF NOT EXISTS idx_metrics_symbol ON aggregated_metrics (symbol);
-CREATE INDEX IF NOT EXISTS idx_metrics_time ON aggregated_metrics (open_time_ms);
\ No newline at end of file
+PRAGMA user_version = 1;
@@ -6,12 +6,39 @@ import time
 
 DB_PATH = '../../db_setup/crypto_data.db' 
 
+# Written by the engine's --partition-hours mode; the newest partitions are read through
+# ATTACH (SQLite attaches at most 10 databases by default)
+PARTITION_DIR = '../../db_setup/partitions'
+MAX_PARTITIONS = 10
+PARTITIONED_TABLES = ['raw_ohlcv_data', 'aggregated_metrics', 'ohlcv_bars', 'indicator_values']
+
+# Bar interval read from ohlcv_bars (1000, 60000, 300000 or 3600000 ms).
+# Set to None to analyze the per-trade rows instead.
+BAR_INTERVAL_MS = 60000
+
 def get_db_path():
     current_dir = os.path.dirname(os.path.abspath(__file__))
     relative_path = os.path.join(current_dir, DB_PATH)
     db_full_path = os.path.abspath(relative_path)
     return db_full_path
 
+def connect():
+    """ Opens the database; with partitions present, the partitioned tables read from them. """
+    conn = sqlite3.connect(get_db_path())
+    partition_dir = os.path.abspath(os.path.join(os.path.dirname(os.path.abspath(__file__)), PARTITION_DIR))
+    if os.path.isdir(partition_dir):
+        # crypto_data_YYYY-MM-DD[THH].db names sort chronologically
+        files = sorted(f for f in os.listdir(partition_dir) if f.startswith('crypto_data_') and f.endswith('.db'))
+        files = files[-MAX_PARTITIONS:]
+        for i, name in enumerate(files):
+            conn.execute(f"ATTACH DATABASE ? AS p{i}", (os.path.join(partition_dir, name),))
+        if files:
+            print(f"Reading {len(files)} partitions from {partition_dir}")
+            for table in PARTITIONED_TABLES:
+                union = " UNION ALL ".join(f"SELECT * FROM p{i}.{table}" for i in range(len(files)))
+                conn.execute(f"CREATE TEMP VIEW {table} AS {union}")
+    return conn
+
 def load_data(symbol, table_name):
     """ Loads data for a given table. """
     db_file_path = get_db_path()
@@ -19,7 +46,7 @@ def load_data(symbol, table_name):
     df = pd.DataFrame()
     
     try:
-        conn = sqlite3.connect(db_file_path)
+        conn = connect()
         print(f"Connected to database: {db_file_path}")
         
         if table_name == 'aggregated_metrics':
@@ -27,12 +54,11 @@ def load_data(symbol, table_name):
                 SELECT 
                     open_time_ms, 
                     trade_id,
-                    symbol, 
                     vwap, 
                     ema_20,
                     ema_50  
                 FROM aggregated_metrics
-                WHERE symbol = '{symbol}'
+                WHERE symbol_id = (SELECT symbol_id FROM symbols WHERE symbol = '{symbol}')
                 ORDER BY open_time_ms ASC
             """
         elif table_name == 'raw_ohlcv_data':
@@ -42,7 +68,7 @@ def load_data(symbol, table_name):
                     trade_id,
                     volume 
                 FROM raw_ohlcv_data
-                WHERE symbol = '{symbol}'
+                WHERE symbol_id = (SELECT symbol_id FROM symbols WHERE symbol = '{symbol}')
                 ORDER BY open_time_ms ASC
             """
         else:
@@ -60,18 +86,57 @@ def load_data(symbol, table_name):
             
     return df
 
-def analyze_and_plot(symbol):
-    
+def load_bars(symbol, interval_ms):
+    """ Loads the engine's OHLCV bars for one interval; EMAs are computed on bar closes. """
+    conn = None
+    df = pd.DataFrame()
+
+    try:
+        conn = connect()
+        query = """
+            SELECT
+                open_time_ms,
+                close_price,
+                volume,
+                quote_volume / volume AS vwap
+            FROM ohlcv_bars
+            WHERE symbol_id = (SELECT symbol_id FROM symbols WHERE symbol = ?) AND interval_ms = ?
+            ORDER BY open_time_ms ASC
+        """
+        df = pd.read_sql_query(query, conn, params=(symbol, interval_ms))
+    except sqlite3.Error as e:
+        print(f"SQLite error while reading from ohlcv_bars: {e}")
+    finally:
+        if conn:
+            conn.close()
+
+    if not df.empty:
+        df['ema_20'] = df['close_price'].ewm(span=20, adjust=False).mean()
+        df['ema_50'] = df['close_price'].ewm(span=50, adjust=False).mean()
+    return df
+
+def load_trades(symbol):
+    """ Loads per-trade metrics joined with trade volume. """
     df_metrics = load_data(symbol, 'aggregated_metrics')
-    
     df_raw = load_data(symbol, 'raw_ohlcv_data')
-
     if df_metrics.empty or df_raw.empty:
+        return pd.DataFrame()
+    return pd.merge(df_metrics, df_raw, on=['open_time_ms', 'trade_id'], how='inner')
+
+def analyze_and_plot(symbol):
+    
+    df = load_bars(symbol, BAR_INTERVAL_MS) if BAR_INTERVAL_MS else pd.DataFrame()
+    bar_width = (BAR_INTERVAL_MS or 0) / 86400000.0  # Matplotlib date units are days
+    if df.empty:
+        if BAR_INTERVAL_MS:
+            print(f"No {BAR_INTERVAL_MS} ms bars for {symbol}; falling back to trade rows.")
+        df = load_trades(symbol)
+        bar_width = 0.0001
+
+    if df.empty:
         print(f"No data found for symbol {symbol} in the database.")
         return
     
-    df = pd.merge(df_metrics, df_raw, on=['open_time_ms', 'trade_id'], how='inner')
-    
     df['timestamp'] = pd.to_datetime(df['open_time_ms'], unit='ms')
     df.set_index('timestamp', inplace=True)
     
@@ -109,7 +174,7 @@ def analyze_and_plot(symbol):
     axes[0].legend(loc='upper left')
 
     # Volume Chart (Donji graf)
-    axes[1].bar(df.index, df['volume'], label='Volume', color='green', width=0.0001)
+    axes[1].bar(df.index, df['volume'], label='Volume', color='green', width=bar_width)
     axes[1].set_xlabel('Time', fontsize=12)
     axes[1].set_ylabel('Volume', fontsize=12)
     axes[1].grid(True)
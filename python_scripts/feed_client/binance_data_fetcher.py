@@ -1,4 +1,6 @@
 import socket
+import struct
+import time
 import datetime
 import asyncio
 from binance import AsyncClient, BinanceSocketManager
@@ -7,19 +9,37 @@ SERVER_IP = "127.0.0.1"
 SERVER_PORT = 12345 
 SYMBOL = 'btcusdt'  
 
+# --- Wire Format ---
+# 'csv'    : one text line per trade (default, understood by every engine version)
+# 'binary' : length-prefixed little-endian frames, see cpp_engine/include/WireProtocol.h
+WIRE_FORMAT = 'csv'
+BINARY_BATCH_SIZE = 20          # Trades per FRAME_TICKS frame
+BINARY_FLUSH_INTERVAL_S = 0.1   # Max time a trade waits for its batch to fill
+
+WIRE_HANDSHAKE_BINARY = 0xB1
+WIRE_VERSION = 1
+FRAME_SYMBOL = 1
+FRAME_TICKS = 2
+FRAME_HEADER = struct.Struct('<IBBH')   # payload_bytes, type, version, count
+WIRE_TICK = struct.Struct('<IIqqdd')    # symbol_id, flags, timestamp_ms, trade_id, price, quantity
+BINARY_SYMBOL_ID = 0
+
 # --- API KEYS ---
 # API keys are not required for public trade streams.
 API_KEY = '' 
 API_SECRET = ''
 
 class LiveTradeClient:
-    def __init__(self, ip, port, symbol):
+    def __init__(self, ip, port, symbol, wire_format=WIRE_FORMAT):
         self.ip = ip
         self.port = port
         self.symbol = symbol
+        self.wire_format = wire_format
         self.tcp_socket = None
         self.client = None
         self.trade_counter = 0 
+        self.pending_ticks = []         # Encoded trades not yet sent; kept across reconnects
+        self.first_pending_time = 0.0
 
     async def connect_to_binance(self):
         """Initializes Binance connection."""
@@ -33,7 +53,9 @@ class LiveTradeClient:
             print(f"[{datetime.datetime.now().strftime('%H:%M:%S')}] Connecting to C++ Engine at {self.ip}:{self.port}...")
             self.tcp_socket = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
             self.tcp_socket.connect((self.ip, self.port))
-            print("Successfully connected to C++ Engine via TCP.")
+            if self.wire_format == 'binary':
+                self.send_binary_handshake()
+            print(f"Successfully connected to C++ Engine via TCP ({self.wire_format}).")
             return True
         except ConnectionRefusedError:
             print("ERROR: Connection refused. Is the C++ Engine running?")
@@ -42,6 +64,54 @@ class LiveTradeClient:
             print(f"An error occurred during TCP connection: {e}")
             return False
 
+    def send_binary_handshake(self):
+        """Negotiates binary frames and declares the symbol id used by every tick."""
+        name = self.symbol.upper().encode('utf-8')
+        payload = struct.pack('<IB', BINARY_SYMBOL_ID, len(name)) + name
+        frame = FRAME_HEADER.pack(len(payload), FRAME_SYMBOL, WIRE_VERSION, 1) + payload
+        self.tcp_socket.sendall(bytes([WIRE_HANDSHAKE_BINARY]) + frame)
+
+    def queue_trade(self, trade_time_ms, trade_id, price, quantity):
+        """Encodes one trade into pending_ticks; send_pending() writes it to the engine."""
+        if not self.pending_ticks:
+            self.first_pending_time = time.monotonic()
+
+        if self.wire_format != 'binary':
+            # Format: timestamp_ms, symbol, trade_id, open, high, low, close, volume
+            # All OHLC are set to trade price for the trade stream
+            data_string = (
+                f"{trade_time_ms},{self.symbol.upper()},{trade_id},{price:.8f},{price:.8f},"
+                f"{price:.8f},{price:.8f},{quantity:.8f}\n" 
+            )
+            self.pending_ticks.append(data_string.encode('utf-8'))
+        else:
+            self.pending_ticks.append(WIRE_TICK.pack(BINARY_SYMBOL_ID, 0, trade_time_ms, trade_id, price, quantity))
+
+    def flush_timeout(self):
+        """Seconds until the pending trades must be sent (0: now), or None if nothing is pending."""
+        if not self.pending_ticks:
+            return None
+        if self.wire_format != 'binary' or len(self.pending_ticks) >= BINARY_BATCH_SIZE:
+            return 0.0
+        return max(0.0, BINARY_FLUSH_INTERVAL_S - (time.monotonic() - self.first_pending_time))
+
+    def send_pending(self):
+        """Sends every pending trade; on a socket error they stay pending for the next connection."""
+        if self.wire_format != 'binary':
+            data = b''.join(self.pending_ticks)
+        else:
+            frames = []
+            for start in range(0, len(self.pending_ticks), BINARY_BATCH_SIZE):
+                ticks = self.pending_ticks[start:start + BINARY_BATCH_SIZE]
+                payload = b''.join(ticks)
+                frames.append(FRAME_HEADER.pack(len(payload), FRAME_TICKS, WIRE_VERSION, len(ticks)) + payload)
+            data = b''.join(frames)
+
+        # A frame cut off by the error is sent again whole after the reconnect handshake;
+        # the engine ignores trades it already stored (same symbol, time and trade ID)
+        self.tcp_socket.sendall(data)
+        self.pending_ticks = []
+
     async def start_trade_feed(self):
         """Subscribes to the live trade feed (@trade) and sends data, including Trade ID, to the C++ Engine."""
         
@@ -49,9 +119,14 @@ class LiveTradeClient:
 
         async with trade_socket as stream:
             while True:
-                msg = await stream.recv()
-                
-                if 'e' in msg and msg['e'] == 'trade':
+                # A partial binary batch must not wait for the next trade on a quiet symbol
+                timeout = self.flush_timeout()
+                try:
+                    msg = await asyncio.wait_for(stream.recv(), timeout) if timeout is not None else await stream.recv()
+                except asyncio.TimeoutError:
+                    msg = None
+
+                if msg and 'e' in msg and msg['e'] == 'trade':
                     trade_time_ms = msg['E'] 
                     trade_id = msg['t']      # Jedinstveni Trade ID
                     price = float(msg['p'])
@@ -59,25 +134,21 @@ class LiveTradeClient:
                     
                     self.trade_counter += 1
                     
-                    # Format: timestamp_ms, symbol, trade_id, open, high, low, close, volume
-                    # All OHLC are set to trade price for the trade stream
-                    data_string = (
-                        f"{trade_time_ms},{self.symbol.upper()},{trade_id},{price:.8f},{price:.8f},"
-                        f"{price:.8f},{price:.8f},{quantity:.8f}\n" 
-                    )
-                    
-                    try:
-                        self.tcp_socket.sendall(data_string.encode('utf-8'))
-                        
-                        if self.trade_counter % 50 == 0:
-                            print(f"[{datetime.datetime.fromtimestamp(trade_time_ms/1000).strftime('%H:%M:%S.%f')[:-3]}] Sent {self.trade_counter} trades. Last Price: {price:.2f} (ID: {trade_id})")
-
-                    except socket.error as e:
-                        print(f"Socket send error: {e}. Attempting to close and reconnect...")
-                        self.tcp_socket.close()
-                        if not self.connect_to_engine():
-                            print("Reconnection failed. Exiting trade feed.")
-                            break 
+                    self.queue_trade(trade_time_ms, trade_id, price, quantity)
+
+                    if self.trade_counter % 50 == 0:
+                        print(f"[{datetime.datetime.fromtimestamp(trade_time_ms/1000).strftime('%H:%M:%S.%f')[:-3]}] Sent {self.trade_counter} trades. Last Price: {price:.2f} (ID: {trade_id})")
+
+                if self.flush_timeout() != 0.0:
+                    continue
+                try:
+                    self.send_pending()
+                except socket.error as e:
+                    print(f"Socket send error: {e}. Attempting to close and reconnect...")
+                    self.tcp_socket.close()
+                    if not self.connect_to_engine():
+                        print(f"Reconnection failed ({len(self.pending_ticks)} trades unsent). Exiting trade feed.")
+                        break 
 
     async def run(self):
         if not self.connect_to_engine():